@@ -18,6 +18,14 @@ defaults=$(<<EOF
 -DK_BOUNDED_SAFETY_AUT_IMPL='k_bounded_safety_aut'
 -DSTATIC_ARRAY_MAX='300'
 -DSTATIC_MAX_BITSETS='8ul'
+-DCAPACITY_BUCKETS='true'
+-DAPPLY_CACHE_SIZE='0'
+-DDELTA_APPLY_MAX='0'
+-DLAZY_ACTIONS='0'
+-DSYMMETRY='0'
+-DPOWSET_WORKERS='1'
+-DPICKER_WORKERS='0'
+-DPIPELINE='0'
 -DSIMD_IS_MAX='true'
 -DAUT_PREPROCESSOR='aut_preprocessors::surely_losing'
 -DBOOLEAN_STATES='boolean_states::forward_saturation'
@@ -57,14 +65,25 @@ confs=(
     [x_is_aut]="-DDEFAULT_UNREAL_X=UNREAL_X_AUTOMATON"
     [nosimd]="-DNO_SIMD"
     [simdnomax]="-DSIMD_IS_MAX=false"
+    [nobuckets]="-DCAPACITY_BUCKETS=false"
+    [applycache]="-DAPPLY_CACHE_SIZE=65536"
+    [deltaapply]="-DDELTA_APPLY_MAX=4"
     [autpreproc_standard]="-DAUT_PREPROCESSOR=aut_preprocessors::standard"
     [autpreproc_nopreproc]="-DAUT_PREPROCESSOR=aut_preprocessors::no_preprocessing"
     [booleanstates_none]="-DBOOLEAN_STATES=boolean_states::no_boolean_states"
     [iosprecom_delegate]="-DIOS_PRECOMPUTER=ios_precomputers::delegate -DACTIONER='actioners::no_ios_precomputation<typename SetOfStates::value_type>'"
     [iosprecom_fake_vars]="-DIOS_PRECOMPUTER=ios_precomputers::fake_vars"
     [iosprecom_powset]="-DIOS_PRECOMPUTER=ios_precomputers::powset"
+    [iosprecom_powset_parallel]="-DIOS_PRECOMPUTER=ios_precomputers::powset -DPOWSET_WORKERS=0"
+    [iosprecom_cached]="-DIOS_PRECOMPUTER='ios_precomputers::cached<ios_precomputers::standard>'"
+    [lazyactions]="-DLAZY_ACTIONS=1"
+    [symmetry]="-DSYMMETRY=1"
+    [pipeline]="-DPIPELINE=1"
     [inputpicker_critical]="-DINPUT_PICKER=input_pickers::critical"
     [inputpicker_critical_pq]="-DINPUT_PICKER=input_pickers::critical_pq"
+    [inputpicker_critical_incr]="-DINPUT_PICKER=input_pickers::critical_incr"
+    [inputpicker_critical_par]="-DINPUT_PICKER=input_pickers::critical_par"
+    [inputpicker_critical_bandit]="-DINPUT_PICKER=input_pickers::critical_bandit"
     [inputpicker_critical_rnd]="-DINPUT_PICKER=input_pickers::critical_rnd"
     [inputpicker_critical_fullrnd]="-DINPUT_PICKER=input_pickers::critical_fullrnd"
     [downset_kdtree]="-DARRAY_AND_BITSET_DOWNSET_IMPL='kdtree_backed' -DVECTOR_AND_BITSET_DOWNSET_IMPL='kdtree_backed'"
@@ -27,6 +27,7 @@
 #include "vectors.hh"
 #include "downsets.hh"
 #include "utils/static_switch.hh"
+#include "utils/buckets.hh"
 #include "boolean_states.hh"
 
 #include <utils/verbose.hh>
@@ -67,7 +68,8 @@ enum
   OPT_VERBOSE = 'v',
   OPT_NEGATIVE = 'N',
   OPT_BRANCH = 'B',
-  OPT_INFINITE = 'F'
+  OPT_INFINITE = 'F',
+  OPT_IOS_CACHE = 256
 };
 
 enum unreal_x_t
@@ -107,6 +109,9 @@ static const argp_option options[] = {
      "semicolon-separated list of infinite examples"
      " propositions",
      0},
+    {"ios-cache", OPT_IOS_CACHE, "DIR", 0,
+     "directory where the IOs precomputed by ios_precomputers::cached are"
+     " stored and reused across runs", 0},
     {"unreal-x", OPT_UNREAL_X, "[formula|automaton|both]", 0,
      "for unrealizability, either add X's to outputs in the"
      " input formula, or push outputs one transition forward in"
@@ -396,14 +401,11 @@ namespace
       constexpr auto max_bools_in_bitsets = vectors::nbitsets_to_nbools(STATIC_MAX_BITSETS);
       auto nbitsetbools = aut->num_states() - vectors::bool_threshold;
       if (nbitsetbools > max_bools_in_bitsets)
-      {
-        verb_do(1, vout << "Warning: bitsets not large enough, using regular vectors for some Boolean states.\n"
+        verb_do(1, vout << "Static bitsets not large enough, using a dynamically sized bitset.\n"
                         /*   */
                         << "\tTotal # of Boolean-for-bitset states: " << nbitsetbools
                         /*   */
-                        << ", max: " << max_bools_in_bitsets << std::endl);
-        nbitsetbools = max_bools_in_bitsets;
-      }
+                        << ", static max: " << max_bools_in_bitsets << std::endl);
 
       constexpr auto STATIC_ARRAY_CAP_MAX =
           vectors::traits<vectors::ARRAY_IMPL, VECTOR_ELT_T>::capacity_for(STATIC_ARRAY_MAX);
@@ -417,6 +419,7 @@ namespace
         nbitsetbools -= (actual_nonbools - nonbools);
 
       vectors::bitset_threshold = aut->num_states() - nbitsetbools;
+      vectors::nbitsetbools = nbitsetbools;
 
       utils::vout << "Bitset threshold set at " << vectors::bitset_threshold << "\n";
 
@@ -424,41 +427,70 @@ namespace
 
       bool realizable = false;
 
+      // The solver is instantiated for bucketed capacities and bitset counts;
+      // the extra lanes and bits are zero, which is neutral.
+      constexpr auto ARRAY_GRANULE =
+          vectors::traits<vectors::ARRAY_IMPL, VECTOR_ELT_T>::capacity_for(1);
+      constexpr auto MAX_CAPACITY_BUCKET =
+          utils::buckets::capacity_index((STATIC_ARRAY_CAP_MAX + ARRAY_GRANULE - 1) / ARRAY_GRANULE);
+      constexpr auto MAX_BITSETS_BUCKET = utils::buckets::bitsets_index(STATIC_MAX_BITSETS);
+      auto nbitsets = vectors::nbools_to_nbitsets(nbitsetbools);
+      // Bitset buckets past STATIC_MAX_BITSETS go to the dynamic bitset.
+      auto bitsets_bucket = (nbitsets <= STATIC_MAX_BITSETS) ? utils::buckets::bitsets_index(nbitsets)
+                                                             : MAX_BITSETS_BUCKET + 1;
+
       if (actual_nonbools <= STATIC_ARRAY_CAP_MAX)
       { // Array & Bitsets
-        static_switch_t<STATIC_ARRAY_CAP_MAX>{}(
-            [&](auto vnonbools)
+        static_switch_t<MAX_CAPACITY_BUCKET>{}(
+            [&](auto vcapbucket)
             {
-              static_switch_t<STATIC_MAX_BITSETS>{}(
-                  [&](auto vbitsets)
+              constexpr auto capacity = utils::buckets::capacity(vcapbucket.value) * ARRAY_GRANULE;
+              static_switch_t<MAX_BITSETS_BUCKET>{}(
+                  [&](auto vbitsetsbucket)
                   {
                     auto skn = K_BOUNDED_SAFETY_AUT_IMPL<
                         downsets::ARRAY_AND_BITSET_DOWNSET_IMPL<
                             vectors::X_and_bitset<
-                                vectors::ARRAY_IMPL<VECTOR_ELT_T, vnonbools.value>,
-                                vbitsets.value>>>(aut, opt_Kmin, opt_K, opt_Kinc, all_inputs, all_outputs);
+                                vectors::ARRAY_IMPL<VECTOR_ELT_T, capacity>,
+                                utils::buckets::bitsets(vbitsetsbucket.value)>>>(aut, opt_Kmin, opt_K, opt_Kinc, all_inputs, all_outputs);
                     realizable = skn.solve();
                   },
-                  UNREACHABLE,
-                  vectors::nbools_to_nbitsets(nbitsetbools));
+                  [&](size_t)
+                  {
+                    auto skn = K_BOUNDED_SAFETY_AUT_IMPL<
+                        downsets::ARRAY_AND_BITSET_DOWNSET_IMPL<
+                            vectors::X_and_bitset<
+                                vectors::ARRAY_IMPL<VECTOR_ELT_T, capacity>,
+                                vectors::dynamic_nbitsets>>>(aut, opt_Kmin, opt_K, opt_Kinc, all_inputs, all_outputs);
+                    realizable = skn.solve();
+                  },
+                  bitsets_bucket);
             },
             UNREACHABLE,
-            actual_nonbools);
+            utils::buckets::capacity_index((actual_nonbools + ARRAY_GRANULE - 1) / ARRAY_GRANULE));
       }
       else
       { // Vectors & Bitsets
-        static_switch_t<STATIC_MAX_BITSETS>{}(
-            [&](auto vbitsets)
+        static_switch_t<MAX_BITSETS_BUCKET>{}(
+            [&](auto vbitsetsbucket)
             {
               auto skn = K_BOUNDED_SAFETY_AUT_IMPL<
                   downsets::VECTOR_AND_BITSET_DOWNSET_IMPL<
                       vectors::X_and_bitset<
                           vectors::VECTOR_IMPL<VECTOR_ELT_T>,
-                          vbitsets.value>>>(aut, opt_Kmin, opt_K, opt_Kinc, all_inputs, all_outputs);
+                          utils::buckets::bitsets(vbitsetsbucket.value)>>>(aut, opt_Kmin, opt_K, opt_Kinc, all_inputs, all_outputs);
               realizable = skn.solve();
             },
-            UNREACHABLE,
-            vectors::nbools_to_nbitsets(nbitsetbools));
+            [&](size_t)
+            {
+              auto skn = K_BOUNDED_SAFETY_AUT_IMPL<
+                  downsets::VECTOR_AND_BITSET_DOWNSET_IMPL<
+                      vectors::X_and_bitset<
+                          vectors::VECTOR_IMPL<VECTOR_ELT_T>,
+                          vectors::dynamic_nbitsets>>>(aut, opt_Kmin, opt_K, opt_Kinc, all_inputs, all_outputs);
+              realizable = skn.solve();
+            },
+            bitsets_bucket);
       }
 
       if (want_time)
@@ -614,6 +646,12 @@ parse_opt(int key, char *arg, struct argp_state *)
     break;
   }
 
+  case OPT_IOS_CACHE:
+  {
+    ios_precomputers::cache_directory = arg;
+    break;
+  }
+
   case 'x':
   {
     const char *opt = extra_options.parse_options(arg);
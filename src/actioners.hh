@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 #include "configuration.hh"
 
 namespace actioners {
@@ -7,6 +9,48 @@ namespace actioners {
       forward,
       backward
     };
+
+    // Actioners implementing apply_block (span, action_vec, direction) apply
+    // an action to a whole block of vectors at once.
+    template <class T, class = void>
+    struct has_apply_block : std::false_type {};
+
+    template <class T>
+    struct has_apply_block<T, std::void_t<decltype (&T::apply_block)>> : std::true_type {};
+
+    // Actioners whose action_vec have an id intern their actions: equal
+    // actions, even of different inputs, have the same id.
+    template <class T, class = void>
+    struct has_action_ids : std::false_type {};
+
+    template <class T>
+    struct has_action_ids<T, std::void_t<decltype (std::declval<typename T::action_vec> ().id)>> : std::true_type {};
+
+    // Actioners implementing pull_input () compile their inputs on demand:
+    // actions () only holds the inputs compiled so far, and pull_input adds
+    // the next one to it, returning a pointer to it, or nullptr if there is
+    // none left.
+    template <class T, class = void>
+    struct has_lazy_inputs : std::false_type {};
+
+    template <class T>
+    struct has_lazy_inputs<T, std::void_t<decltype (&T::pull_input)>> : std::true_type {};
+
+    // Actioners implementing apply_forward (m, avec, buffers) apply forward
+    // without changing the actioner, using buffers from make_buffers ().
+    template <class T, class = void>
+    struct has_apply_forward : std::false_type {};
+
+    template <class T>
+    struct has_apply_forward<T, std::void_t<decltype (&T::make_buffers)>> : std::true_type {};
+
+    // Actioners implementing cache_stats () return the hits and misses of
+    // their cache of apply results.
+    template <class T, class = void>
+    struct has_cache_stats : std::false_type {};
+
+    template <class T>
+    struct has_cache_stats<T, std::void_t<decltype (&T::cache_stats)>> : std::true_type {};
 }
 
 #include "actioners/standard.hh"
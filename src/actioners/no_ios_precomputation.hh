@@ -1,138 +1,165 @@
 #pragma once
 
+#include <iterator>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace actioners {
   namespace detail {
-    template <typename State, typename Aut, typename Supports>
-    class no_ios_precomputation {
-      public: // types
-        using action = std::vector<std::pair<unsigned, bool>>; // All these pairs are unique by construction.
-        using action_vec = std::vector<action>;          // Vector indexed by state number
-        using action_vecs = std::list<action_vec>;
-        using input_and_actions = std::pair<bdd, action_vecs>;
-        struct compare_actions {
-            // WORST: all code with not
-            bool operator() (const input_and_actions& x, const input_and_actions& y) const {
-              return (x.second < y.second);
-              // Let's favor the actions with the most potential for -1.
-              auto num_accepting_of = [this] (const action_vecs& x) {
-                int num_accepting = 0;
-                for (const auto& tav : x)
-                  for (const auto& ta : tav)
-                    for (const auto& [_, accepting] : ta)
-                      if (accepting) num_accepting++;
-                return num_accepting;
-              };
-
-              auto x_acc = num_accepting_of (x.second),
-                y_acc = num_accepting_of (y.second);
-
-              if (x_acc < y_acc)
-                return not true;
-              if (x_acc > y_acc)
-                return not false;
-              return not (x.second < y.second);
-            }
-        };
-        using input_and_actions_set = std::list<input_and_actions>;
-      public:
-        no_ios_precomputation (const Aut& aut, const Supports& supports, int K) :
-          aut {aut}, K {K},
-          apply_out (aut->num_states ()), mcopy (aut->num_states ()) {
-
-          mcopy.reserve (State::capacity_for (mcopy.size ()));
-
-          std::map<action_vecs, bdd> ioset;
-          bdd input_letters = bddtrue;
-          while (input_letters != bddfalse) {
-            bdd one_input_letter = pick_one_letter (input_letters, supports.first);
-            action_vecs fwd_actions;
-            bdd output_letters = bddtrue;
-            while (output_letters != bddfalse) {
-              bdd one_output_letter = pick_one_letter (output_letters, supports.second);
-              const auto& fwd = compute_action (one_input_letter & one_output_letter);
-              fwd_actions.push_back (std::move (fwd));
+    static bdd pick_one_letter (bdd& letter_set, const bdd& support) {
+      bdd one_letter = bdd_satoneset (letter_set,
+                                      support,
+                                      bddtrue);
+      letter_set -= one_letter;
+      return one_letter;
+    }
+
+    // The transitions enabled by each letter, computed straight from the
+    // automaton, in the format of the IOs precomputers: a range of inputs,
+    // each with the set of transitions of each output.  An input is only
+    // computed when the range reaches it, so with LAZY_ACTIONS, only the
+    // inputs pulled by the pickers are ever computed.
+    //
+    // The edge conditions are deduplicated, then cofactored by each input.
+    // The cofactors only depend on the outputs, and are shared by many
+    // conditions and many inputs: the outputs that satisfy a cofactor are
+    // evaluated the first time it is seen, and kept in a table with one bit
+    // per output, shared by all the inputs.  The outputs that agree on all
+    // the cofactors of an input enable the same transitions, so a single
+    // transition set is built for each class of such outputs.
+    template <typename Aut>
+    class letters_transitions {
+        using transset = std::vector<std::pair<unsigned, unsigned>>;
+
+        struct table {
+            std::vector<std::pair<unsigned, unsigned>> edges;
+            std::vector<unsigned> edge_cond; // Index in conds of the condition of each edge.
+            std::vector<bdd> conds;
+            std::vector<bdd> outputs;
+            std::vector<bdd> cofactors; // Kept so that their ids stay valid.
+            std::map<int, unsigned> cofactor_index; // By BDD id.
+            std::vector<std::vector<bool>> cofactor_outputs; // Whether each output satisfies each cofactor.
+
+            unsigned cofactor (const bdd& c) {
+              auto [it, inserted] = cofactor_index.emplace (c.id (), cofactors.size ());
+              if (inserted) {
+                cofactors.push_back (c);
+                auto& holds = cofactor_outputs.emplace_back (outputs.size (), c == bddtrue);
+                if (c != bddtrue and c != bddfalse)
+                  for (size_t o = 0; o < outputs.size (); ++o)
+                    holds[o] = (bdd_restrict (c, outputs[o]) == bddtrue);
+              }
+              return it->second;
             }
-            ioset[fwd_actions] = one_input_letter;
-          }
 
-          for (auto it = ioset.begin(); it != ioset.end(); ) {
-            auto e = ioset.extract (it++);
-            input_output_fwd_actions.emplace_back (e.mapped (), std::move (e.key ()));
-          }
-        }
+            std::vector<transset> ios_of (const bdd& input) {
+              // The cofactors of this input, and that of each condition.
+              std::vector<unsigned> local, cond_local (conds.size ());
+              std::map<unsigned, unsigned> local_index;
+              for (size_t c = 0; c < conds.size (); ++c) {
+                auto [it, inserted] = local_index.emplace (cofactor (bdd_restrict (conds[c], input)),
+                                                           local.size ());
+                if (inserted)
+                  local.push_back (it->first);
+                cond_local[c] = it->second;
+              }
 
-        void setK (int newK) { K = newK; }
-
-        auto& actions () { return input_output_fwd_actions; }
-
-        State apply (const State& m, const action_vec& avec, direction dir) /* __attribute__((pure)) */ {
-          if (dir == direction::forward)
-            apply_out.assign (m.size (), (char) -1);
-          else {
-            // Non boolean
-            std::fill_n (apply_out.begin (),
-                         vectors::bool_threshold,
-                         (char) (K - 1));
-            // Boolean
-            std::fill_n (apply_out.begin () + vectors::bool_threshold,
-                         m.size () - vectors::bool_threshold,
-                         (char) 0);
-          }
-
-          m.to_vector (mcopy);
-
-          for (size_t p = 0; p < m.size (); ++p) {
-            for (const auto& [q, q_final] : avec[p]) {
-              if (dir == direction::forward) {
-                if (mcopy[q] != -1)
-                  apply_out[p] = std::max (apply_out[p], std::min ((char) K, (char) (mcopy[q] + (char) (q_final ? 1 : 0))));
-              } else
-                if (apply_out[q] != -1)
-                  apply_out[q] = std::min (apply_out[q], std::max ((char) -1, (char) (mcopy[p] - (char) (q_final ? 1 : 0))));
-
-              // If we reached the extreme value, stop going through states.
-              if (dir == direction::forward && apply_out[p] == K)
-                break;
+              std::vector<transset> ios;
+              std::map<std::vector<bool>, unsigned> classes;
+              for (size_t o = 0; o < outputs.size (); ++o) {
+                std::vector<bool> holds (local.size ());
+                for (size_t l = 0; l < local.size (); ++l)
+                  holds[l] = cofactor_outputs[local[l]][o];
+                auto [it, inserted] = classes.emplace (std::move (holds), ios.size ());
+                if (not inserted)
+                  continue;
+                auto& transitions = ios.emplace_back ();
+                for (size_t e = 0; e < edges.size (); ++e)
+                  if (it->first[cond_local[edge_cond[e]]])
+                    transitions.push_back (edges[e]);
+              }
+              return ios;
             }
-          }
+        };
 
-          return State (apply_out);
+      public:
+        template <typename Supports>
+        letters_transitions (const Aut& aut, const Supports& supports) :
+          input_support {supports.first}, tab {std::make_shared<table> ()} {
+          std::map<int, unsigned> cond_index; // By BDD id.
+          for (size_t p = 0; p < aut->num_states (); ++p)
+            for (const auto& e : aut->out (p)) {
+              auto [it, inserted] = cond_index.emplace (e.cond.id (), tab->conds.size ());
+              if (inserted)
+                tab->conds.push_back (e.cond);
+              tab->edges.emplace_back (p, e.dst);
+              tab->edge_cond.push_back (it->second);
+            }
+          bdd output_letters = bddtrue;
+          while (output_letters != bddfalse)
+            tab->outputs.push_back (pick_one_letter (output_letters, supports.second));
         }
 
-      private:
-        const Aut& aut;
-        int K;
-        utils::vector_mm<char> apply_out, mcopy;
-        input_and_actions_set input_output_fwd_actions;
+        class iterator {
+          public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::pair<bdd, std::vector<transset>>;
 
-        auto compute_action (bdd letter) {
-          action_vec ret_fwd (aut->num_states ());
+            iterator (std::shared_ptr<table> tab, bdd input_letters, bdd input_support) :
+              tab {tab}, input_letters {input_letters}, input_support {input_support}
+            { ++*this; }
 
-          for (size_t p = 0; p < aut->num_states (); ++p) {
-            for (const auto& e : aut->out (p)) {
-              unsigned q = e.dst;
-              if ((e.cond & letter) != bddfalse) {
-                ret_fwd[q].push_back (std::make_pair (p, aut->state_is_accepting (q)));
+            iterator () : at_end {true} {}
+
+            iterator& operator++ () {
+              if (input_letters == bddfalse)
+                at_end = true;
+              else {
+                bdd input = pick_one_letter (input_letters, input_support);
+                current = value_type (input, tab->ios_of (input));
               }
+              return *this;
             }
-          }
-          return ret_fwd;
-        }
-        static bdd pick_one_letter (bdd& letter_set, const bdd& support) {
-          bdd one_letter = bdd_satoneset (letter_set,
-                                          support,
-                                          bddtrue);
-          letter_set -= one_letter;
-          return one_letter;
-        }
+
+            const value_type& operator* () const { return current; }
+            const value_type* operator-> () const { return &current; }
+
+            bool operator== (const iterator& rhs) const {
+              return at_end == rhs.at_end and (at_end or input_letters == rhs.input_letters);
+            }
+            bool operator!= (const iterator& rhs) const {
+              return not (*this == rhs);
+            }
+
+          private:
+            std::shared_ptr<table> tab;
+            bdd input_letters = bddfalse, input_support = bddtrue;
+            bool at_end = false;
+            value_type current;
+        };
+
+        // The copies share the table.
+        iterator begin () const { return iterator (tab, bddtrue, input_support); }
+        iterator end () const { return iterator (); }
+
+      private:
+        bdd input_support;
+        std::shared_ptr<table> tab;
     };
   }
 
+  // Actioner for when the IOs were not precomputed (ios_precomputers::delegate
+  // only passes the supports along).  The transitions of each letter are
+  // computed here as the standard actioner reads them, so that the actions
+  // are stored and applied as with the other precomputers.
   template <typename State>
   struct no_ios_precomputation {
       template <typename Aut, typename Supports>
       static auto make (const Aut& aut, const Supports& supports, int K) {
-        return detail::no_ios_precomputation<State, Aut, Supports> (aut, supports, K);
+        auto inputs_to_ios = detail::letters_transitions<Aut> (aut, supports);
+        return detail::standard<State, Aut, decltype (inputs_to_ios)> (aut, inputs_to_ios, K);
       }
   };
 }
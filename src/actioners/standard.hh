@@ -1,44 +1,92 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <map>
+#include <optional>
+#include <set>
+#include <span>
+#include <string_view>
+
+#include "utils/clock_cache.hh"
+#include "utils/simd_traits.hh"
+
 namespace actioners {
   namespace detail {
     template <typename State, typename Aut, typename IToIOs>
     class standard {
       public: // types
 
-        using action = std::vector<std::pair<unsigned, bool>>; // All these pairs are unique by construction.
-        using action_vec = std::vector<action>;          // Vector indexed by state number
+        // Actions are stored in CSR form: all the output actions of an input
+        // share one contiguous block, and an action_vec is a view into it.
+        struct action_block {
+            // offsets[j * (n + 1) + q] to offsets[j * (n + 1) + q + 1] delimit,
+            // in sources, the sources of the transitions to q of output j.
+            std::vector<unsigned> offsets;
+            std::vector<unsigned> sources;
+            // Gather tables for the backward kernel, see compile_gather.
+            std::vector<uint16_t> gathers;
+            // Rows for the Boolean part, see compile_bools.
+            std::vector<unsigned> bool_states;
+            std::vector<unsigned long> bool_masks;
+            // Same as offsets and sources, for the successors of each state.
+            // Only used by apply_delta.
+            std::vector<unsigned> succ_offsets;
+            std::vector<unsigned> succs;
+        };
+
+        // Bit-parallel transfer of the states in the bitset part of State: row
+        // r associates the state states[r] with a bitset over the Boolean
+        // states, of bool_words words at masks + r * bool_words.
+        struct bool_rows {
+            const unsigned* states;
+            const unsigned long* masks;
+            unsigned count;
+        };
+
+        struct action_vec {
+            const unsigned* offsets; // n + 1 entries, indexed by destination.
+            const unsigned* sources;
+            // If nonnull, ranks tables of padded_n entries: the r-th table
+            // maps each state to its r-th successor, or to n if it has fewer.
+            const uint16_t* gather;
+            unsigned ranks;
+            // Forward: a source and its successors in the bitset part.
+            // Backward: a destination and its predecessors in the bitset part.
+            bool_rows bools_fwd, bools_bwd;
+            const unsigned* succ_offsets; // n + 1 entries, indexed by source.
+            const unsigned* succs;
+            unsigned id; // Equal actions, even of different inputs, have the same id.
+        };
         using action_vecs = std::list<action_vec>;
         using input_and_actions = std::pair<bdd, action_vecs>;
+        using input_and_actions_set = std::list<input_and_actions>;
+
+      private:
+        // Uncompiled actions, used to deduplicate the inputs on construction.
+        using raw_action_vec = std::vector<std::vector<unsigned>>; // Sources, indexed by destination.
+        using raw_action_vecs = std::list<raw_action_vec>;
+        using raw_input_and_actions = std::pair<bdd, raw_action_vecs>;
         struct compare_actions {
-            // WORST: all code with not
-            bool operator() (const input_and_actions& x, const input_and_actions& y) const {
+            bool operator() (const raw_input_and_actions& x, const raw_input_and_actions& y) const {
               return (x.second < y.second);
-              // Let's favor the actions with the most potential for -1.
-              auto num_accepting_of = [this] (const action_vecs& x) {
-                int num_accepting = 0;
-                for (const auto& tav : x)
-                  for (const auto& ta : tav)
-                    for (const auto& [_, accepting] : ta)
-                      if (accepting) num_accepting++;
-                return num_accepting;
-              };
-
-              auto x_acc = num_accepting_of (x.second),
-                y_acc = num_accepting_of (y.second);
-
-              if (x_acc < y_acc)
-                return not true;
-              if (x_acc > y_acc)
-                return not false;
-              return not (x.second < y.second);
             }
         };
-        using input_and_actions_set = std::list<input_and_actions>;
+
       public:
         standard (const Aut& aut, const IToIOs& inputs_to_ios, int K) :
           aut {aut}, K {(char) K},
-          apply_out (aut->num_states ()), mcopy (aut->num_states ()), backward_reset (aut->num_states ()) {
+          apply_out (aut->num_states ()), mcopy (aut->num_states ()), backward_reset (aut->num_states ()),
+          padded_n {simd_traits::capacity_for (aut->num_states ())},
+          bwd_t (simd_traits::capacity_for (aut->num_states () + 1)), bwd_out (padded_n),
+          block_in (aut->num_states () * block_size), block_out (aut->num_states () * block_size),
+          block_t (block_size),
+          split_at {(vectors::has_bitset<State>::value and vectors::bitset_threshold < aut->num_states ()) ?
+                    vectors::bitset_threshold : aut->num_states ()},
+          bool_words {vectors::nbools_to_nbitsets (aut->num_states () - split_at)},
+          bool_out (bool_words),
+          accepting (aut->num_states ()) {
 
           mcopy.reserve (State::capacity_for (mcopy.size ()));
 
@@ -51,19 +99,31 @@ namespace actioners {
                        aut->num_states () - vectors::bool_threshold,
                        (char) 0);
 
-          std::set<input_and_actions, compare_actions> ioset;
+          for (size_t q = 0; q < aut->num_states (); ++q)
+            accepting[q] = aut->state_is_accepting (q) ? 1 : 0;
 
-          for (const auto& [input, ios] : inputs_to_ios) {
-            std::list<action_vec> fwd_actions;
-            for (const auto& transset : ios) {
-              fwd_actions.push_back (compute_action_vec (transset));
+          if constexpr (LAZY_ACTIONS) {
+            // The inputs are compiled by pull_input, when a picker needs them.
+            lazy_ios.emplace (inputs_to_ios);
+            next_ios.emplace (lazy_ios->begin ());
+            end_ios.emplace (lazy_ios->end ());
+          }
+          else {
+            std::set<raw_input_and_actions, compare_actions> ioset;
+            for (const auto& [input, ios] : inputs_to_ios) {
+              ioset.insert (std::pair (input, raw_actions_of (ios)));
+              all_inputs++;
             }
-            ioset.insert (std::pair (input, std::move (fwd_actions)));
+            dominated_inputs = prune_dominated (ioset);
+            for (const auto& [input, raw_actions] : ioset)
+              input_output_fwd_actions.emplace_back (input, compile (raw_actions));
+            action_stats ();
           }
+        }
 
-          for (auto it = ioset.begin(); it != ioset.end(); ) {
-            input_output_fwd_actions.push_back (std::move (ioset.extract (it++).value ()));
-          }
+        ~standard () {
+          if constexpr (LAZY_ACTIONS)
+            action_stats ();
         }
 
         void setK (int newK) {
@@ -71,53 +131,736 @@ namespace actioners {
 	  std::fill_n (backward_reset.begin (),
                        vectors::bool_threshold,
                        (char) (K - 1));
+          // The cached and remembered results depend on K.
+          apply_cache.clear ();
+          for (auto& memo : delta_memos)
+            memo.in.clear ();
 	}
 
+        int getK () const { return K; }
+
+        // The hits and misses of the apply cache so far, see APPLY_CACHE_SIZE.
+        std::pair<size_t, size_t> cache_stats () const {
+          return {apply_cache.hits, apply_cache.misses};
+        }
+
+        // Scratch buffers for apply_forward.
+        struct buffers {
+            utils::vector_mm<char> out;
+            std::vector<unsigned long> bools;
+        };
+
+        buffers make_buffers () const {
+          return {utils::vector_mm<char> (aut->num_states ()), std::vector<unsigned long> (bool_words)};
+        }
+
+        // Same as apply (m, avec, direction::forward), but only reads the
+        // actioner, so that it can be called from several threads, each with
+        // its own buffers.  The caches are not used.
+        State apply_forward (const State& m, const action_vec& avec, buffers& buf) const {
+          auto value_of = [&m] (size_t s) { return (char) m[s]; };
+          scalar_apply (avec, direction::forward, value_of, buf.out);
+          return make_state (avec, direction::forward, value_of, [&buf] (size_t p) { return buf.out[p]; },
+                             buf.out, buf.bools);
+        }
+
         auto& actions () { return input_output_fwd_actions; }
 
-        State apply (const State& m, const action_vec& avec, direction dir) /* __attribute__((pure)) */ {
+        // Compiles the next input of inputs_to_ios that is not weaker (see
+        // weaker_input) than an input already compiled, appends it to
+        // actions (), and returns it.  Returns nullptr once all the inputs are compiled, which
+        // is always the case if LAZY_ACTIONS is not set.
+        input_and_actions* pull_input () {
+          if constexpr (LAZY_ACTIONS) {
+            while (next_ios and *next_ios != *end_ios) {
+              const auto& [input, ios] = **next_ios;
+              bdd the_input = input;
+              auto raw_actions = raw_actions_of (ios);
+              ++*next_ios;
+              all_inputs++;
+              if (pulled_actions.contains (raw_actions))
+                continue;
+              // The inputs already pulled stay, so only the new one may go.
+              if (std::any_of (pulled_actions.begin (), pulled_actions.end (), [&] (const auto& pulled) {
+                    return weaker_input (raw_actions, pulled);
+                  })) {
+                dominated_inputs++;
+                continue;
+              }
+              auto raw = pulled_actions.insert (std::move (raw_actions)).first;
+              return &input_output_fwd_actions.emplace_back (the_input, compile (*raw));
+            }
+            if (next_ios) {
+              verb_do (1, vout << "All inputs compiled." << std::endl);
+              next_ios.reset ();
+              end_ios.reset ();
+              lazy_ios.reset ();
+              pulled_actions.clear ();
+            }
+          }
+          return nullptr;
+        }
+
+        State apply (const State& m, const action_vec& avec, direction dir) {
+          if constexpr (APPLY_CACHE_SIZE == 0)
+            return apply_uncached (m, avec, dir);
+          else {
+            auto key = cache_key (m, avec, dir);
+            if (auto* hit = cache_find (key, m))
+              return hit->copy ();
+            auto res = apply_uncached (m, avec, dir);
+            apply_cache.insert (key, {m.copy (), res.copy ()});
+            return res;
+          }
+        }
+
+        // Applies avec to all the vectors of ms, see apply_block_uncached.
+        std::vector<State> apply_block (std::span<const State> ms, const action_vec& avec, direction dir) {
+          if constexpr (APPLY_CACHE_SIZE == 0)
+            return apply_block_uncached (ms, avec, dir);
+          else {
+            // Only the vectors with no cached result go through the kernel.
+            std::vector<std::optional<State>> out (ms.size ());
+            std::vector<apply_key> keys;
+            std::vector<State> misses;
+            std::vector<size_t> miss_pos;
+            for (size_t i = 0; i < ms.size (); ++i) {
+              auto key = cache_key (ms[i], avec, dir);
+              if (auto* hit = cache_find (key, ms[i]))
+                out[i].emplace (hit->copy ());
+              else {
+                keys.push_back (key);
+                misses.push_back (ms[i].copy ());
+                miss_pos.push_back (i);
+              }
+            }
+
+            auto computed = apply_block_uncached (misses, avec, dir);
+            for (size_t j = 0; j < computed.size (); ++j) {
+              apply_cache.insert (keys[j], {std::move (misses[j]), computed[j].copy ()});
+              out[miss_pos[j]].emplace (std::move (computed[j]));
+            }
+
+            std::vector<State> res;
+            res.reserve (ms.size ());
+            for (auto& o : out)
+              res.push_back (std::move (*o));
+            return res;
+          }
+        }
+
+       private:
+        State apply_uncached (const State& m, const action_vec& avec, direction dir) /* __attribute__((pure)) */ {
+          if constexpr (DELTA_APPLY_MAX > 0)
+            return apply_delta (m, avec, dir);
+
+          if (dir == direction::backward and avec.gather) {
+            m.to_vector (mcopy);
+            backward_gather (avec);
+            return make_state (avec, dir, [this] (size_t s) { return mcopy[s]; },
+                               [this] (size_t p) { return bwd_out[p]; }, apply_out, bool_out);
+          }
+
+          auto value_of = [&m] (size_t s) { return (char) m[s]; };
+          scalar_apply (avec, dir, value_of, apply_out);
+          return make_state (avec, dir, value_of, [this] (size_t p) { return apply_out[p]; },
+                             apply_out, bool_out);
+        }
+
+        // Computes out from scratch, value_of (s) being the value of state s
+        // in the input vector.
+        template <typename ValueOf>
+        void scalar_apply (const action_vec& avec, direction dir, const ValueOf& value_of,
+                          utils::vector_mm<char>& out) const {
+          const size_t n = aut->num_states ();
           if (dir == direction::forward)
-            apply_out.assign (m.size (), (char) -1);
+            out.assign (n, (char) -1);
           else
-            apply_out = backward_reset;
-
-          //m.to_vector (mcopy);
+            out = backward_reset;
 
-          for (size_t p = 0; p < m.size (); ++p) {
-            for (const auto& [q, q_final] : avec[p]) {
+          // The destinations at and after split_at, if any, are done by apply_bools.
+          const size_t last = (dir == direction::forward) ? split_at : n;
+          for (size_t p = 0; p < last; ++p) {
+            const char p_final = accepting[p];
+            const auto end = avec.offsets[p + 1];
+            for (auto i = avec.offsets[p]; i < end; ++i) {
+              const auto q = avec.sources[i];
               if (dir == direction::forward) {
-                if (m[q] != -1)
-                  apply_out[p] = std::max (apply_out[p], std::min ((char) K, (char) (m[q] + (char) (q_final ? 1 : 0))));
+                if (value_of (q) != -1)
+                  out[p] = std::max (out[p], std::min ((char) K, (char) (value_of (q) + p_final)));
               } else
-                if (apply_out[q] != -1)
-                  apply_out[q] = std::min (apply_out[q], std::max ((char) -1, (char) (m[p] - (char) (q_final ? 1 : 0))));
+                if (q < split_at and out[q] != -1)
+                  out[q] = std::min (out[q], std::max ((char) -1, (char) (value_of (p) - p_final)));
 
               // If we reached the extreme value, stop going through states.
-              if (dir == direction::forward && apply_out[p] == K)
+              if (dir == direction::forward && out[p] == K)
                 break;
             }
           }
+        }
+
+        // The actioner remembers, for each action and direction, the last
+        // input vector and its result.  The input vectors that are applied an
+        // action in turn, e.g., the elements of F, often differ in only a few
+        // coordinates, so only the destinations that depend on these are
+        // recomputed, using the reverse index of the action (succ_offsets
+        // and succs).  If more than DELTA_APPLY_MAX coordinates changed, the
+        // whole result is recomputed, with the gather kernel if it applies.
+        //
+        // The input is still read in full, to find the changed coordinates:
+        // this is a pass over the states, not over the transitions of the
+        // action, so it only pays when the action has many more transitions
+        // than the automaton has states.
+        State apply_delta (const State& m, const action_vec& avec, direction dir) {
+          const size_t n = aut->num_states ();
+          m.to_vector (mcopy);
+          auto& memo = delta_memos[2 * avec.id + (dir == direction::forward)];
+
+          std::array<size_t, DELTA_APPLY_MAX> changed;
+          size_t nchanged = 0;
+          if (not memo.in.empty ())
+            for (size_t c = 0; c < n and nchanged <= DELTA_APPLY_MAX; ++c)
+              if (mcopy[c] != memo.in[c]) {
+                if (nchanged < DELTA_APPLY_MAX)
+                  changed[nchanged] = c;
+                ++nchanged;
+              }
 
-          return State (apply_out);
+          if (memo.in.empty () or nchanged > DELTA_APPLY_MAX) {
+            if (dir == direction::backward and avec.gather) {
+              backward_gather (avec);
+              std::copy_n (bwd_out.begin (), n, apply_out.begin ());
+            }
+            else
+              scalar_apply (avec, dir, [this] (size_t s) { return mcopy[s]; }, apply_out);
+          }
+          else {
+            std::copy (memo.out.begin (), memo.out.end (), apply_out.begin ());
+            for (size_t j = 0; j < nchanged; ++j) {
+              const size_t c = changed[j];
+              // Forward: the successors of c depend on c.  Backward: the
+              // sources of the transitions to c depend on c.
+              if (dir == direction::forward)
+                for (auto i = avec.succ_offsets[c]; i < avec.succ_offsets[c + 1]; ++i)
+                  recompute (avec, dir, avec.succs[i]);
+              else
+                for (auto i = avec.offsets[c]; i < avec.offsets[c + 1]; ++i)
+                  recompute (avec, dir, avec.sources[i]);
+            }
+          }
+
+          memo.in.assign (mcopy.begin (), mcopy.begin () + n);
+          memo.out.assign (apply_out.begin (), apply_out.begin () + split_at);
+          return make_state (avec, dir, [this] (size_t s) { return mcopy[s]; },
+                             [this] (size_t p) { return apply_out[p]; }, apply_out, bool_out);
+        }
+
+        // Computes apply_out[p] from mcopy.
+        void recompute (const action_vec& avec, direction dir, size_t p) {
+          if (p >= split_at)
+            return;
+          char v;
+          if (dir == direction::forward) {
+            v = -1;
+            for (auto i = avec.offsets[p]; i < avec.offsets[p + 1]; ++i) {
+              const auto q = avec.sources[i];
+              if (mcopy[q] != -1)
+                v = std::max (v, std::min (K, (char) (mcopy[q] + accepting[p])));
+            }
+          }
+          else {
+            v = backward_reset[p];
+            for (auto i = avec.succ_offsets[p]; i < avec.succ_offsets[p + 1]; ++i) {
+              const auto s = avec.succs[i];
+              v = std::min (v, std::max ((char) -1, (char) (mcopy[s] - accepting[s])));
+            }
+          }
+          apply_out[p] = v;
+        }
+
+        // Applies avec to all the vectors of ms.  The vectors are transposed
+        // by groups of block_size, so that the loops over the transitions run
+        // once per group, and the innermost loops run across the vectors.
+        // This does not use apply_delta: a vector costs the kernel a
+        // block_size-th of a pass over the transitions, which is usually less
+        // than the pass over the states that apply_delta needs to find the
+        // changed coordinates.
+        std::vector<State> apply_block_uncached (std::span<const State> ms, const action_vec& avec, direction dir) {
+          const size_t n = aut->num_states ();
+          std::vector<State> res;
+          res.reserve (ms.size ());
+
+          for (size_t start = 0; start < ms.size (); start += block_size) {
+            const size_t nelts = std::min (block_size, ms.size () - start);
+
+            // block_in[p * block_size + e] is the p-th component of vector e.
+            for (size_t e = 0; e < nelts; ++e) {
+              ms[start + e].to_vector (mcopy);
+              for (size_t p = 0; p < n; ++p)
+                block_in[p * block_size + e] = mcopy[p];
+            }
+
+            if (dir == direction::forward) {
+              std::fill (block_out.begin (), block_out.end (), (char) -1);
+              for (size_t p = 0; p < split_at; ++p) {
+                const char p_final = accepting[p];
+                char* out = &block_out[p * block_size];
+                for (auto i = avec.offsets[p]; i < avec.offsets[p + 1]; ++i) {
+                  const char* in = &block_in[avec.sources[i] * block_size];
+                  for (size_t e = 0; e < block_size; ++e) {
+                    char v = (in[e] == -1) ? (char) -1 : std::min (K, (char) (in[e] + p_final));
+                    out[e] = std::max (out[e], v);
+                  }
+                }
+              }
+            }
+            else {
+              for (size_t q = 0; q < n; ++q)
+                std::fill_n (&block_out[q * block_size], block_size, backward_reset[q]);
+              for (size_t p = 0; p < n; ++p) {
+                if (avec.offsets[p] == avec.offsets[p + 1])
+                  continue;
+                const char p_final = accepting[p];
+                const char* in = &block_in[p * block_size];
+                for (size_t e = 0; e < block_size; ++e)
+                  block_t[e] = std::max ((char) -1, (char) (in[e] - p_final));
+                for (auto i = avec.offsets[p]; i < avec.offsets[p + 1]; ++i) {
+                  if (avec.sources[i] >= split_at)
+                    continue;
+                  char* out = &block_out[avec.sources[i] * block_size];
+                  for (size_t e = 0; e < block_size; ++e)
+                    out[e] = std::min (out[e], block_t[e]);
+                }
+              }
+            }
+
+            for (size_t e = 0; e < nelts; ++e)
+              res.push_back (make_state (avec, dir,
+                                         [this, e] (size_t s) { return block_in[s * block_size + e]; },
+                                         [this, e] (size_t p) { return block_out[p * block_size + e]; },
+                                         apply_out, bool_out));
+          }
+
+          return res;
+        }
+
+        // K is not part of the key, as the cache is emptied when it changes.
+        // The key only holds a hash of the vector, computed in place; the
+        // entries keep their input vector, which a hit must be equal to, so
+        // that a collision is a miss.
+        struct apply_key {
+            size_t hash;
+            unsigned action;
+            direction dir;
+            bool operator== (const apply_key&) const = default;
+        };
+
+        struct apply_key_hash {
+            size_t operator() (const apply_key& key) const {
+              return key.hash ^ ((key.action * 2 + (key.dir == direction::forward)) * 0x9e3779b97f4a7c15ul);
+            }
+        };
+
+        struct cached_apply {
+            State in, out;
+        };
+
+        apply_key cache_key (const State& m, const action_vec& avec, direction dir) {
+          m.to_vector (mcopy);
+          return {std::hash<std::string_view> () (std::string_view (mcopy.data (), m.size ())), avec.id, dir};
+        }
+
+        const State* cache_find (const apply_key& key, const State& m) {
+          auto* hit = apply_cache.find (key);
+          return (hit and hit->in == m) ? &hit->out : nullptr;
+        }
+
+        using simd_traits = utils::simd_traits<char>;
+        static constexpr size_t block_size = 64;
+        static constexpr size_t bits_per_word = sizeof (unsigned long) * 8;
+
+        // Backward apply from mcopy into bwd_out, with all the destinations
+        // processed at once:
+        //   out[q] = min (reset[q], min over successors p of q of t[p]),
+        // with t[p] = max (-1, m[p] - accepting[p]), and t[n] = 127 for
+        // missing successors.
+        void backward_gather (const action_vec& avec) {
+          const size_t n = aut->num_states ();
+
+          for (size_t p = 0; p < n; ++p)
+            bwd_t[p] = std::max ((char) -1, (char) (mcopy[p] - accepting[p]));
+          bwd_t[n] = std::numeric_limits<char>::max ();
+
+          std::copy_n (backward_reset.begin (), n, bwd_out.begin ());
+
+#ifndef NO_SIMD
+          using fssimd = typename simd_traits::fssimd;
+          for (size_t base = 0; base < padded_n; base += simd_traits::simd_size) {
+            fssimd out (&bwd_out[base], std::experimental::vector_aligned);
+            for (unsigned r = 0; r < avec.ranks; ++r) {
+              const uint16_t* idx = avec.gather + r * padded_n + base;
+              out = std::experimental::min (out, fssimd ([&] (auto i) { return bwd_t[idx[i]]; }));
+            }
+            out.copy_to (&bwd_out[base], std::experimental::vector_aligned);
+          }
+#else
+          for (unsigned r = 0; r < avec.ranks; ++r) {
+            const uint16_t* idx = avec.gather + r * padded_n;
+            for (size_t q = 0; q < n; ++q)
+              bwd_out[q] = std::min (bwd_out[q], bwd_t[idx[q]]);
+          }
+#endif
+        }
+
+        // Builds the result, where out_of (p) is the value computed for the
+        // destination p, except for the states at and after split_at, which
+        // are computed with apply_bools.  When State can be built in place,
+        // the values are written directly into it, and summed on the way.
+        // out and bools are scratch buffers.
+        template <typename ValueOf, typename OutOf>
+        State make_state (const action_vec& avec, direction dir,
+                          const ValueOf& value_of, const OutOf& out_of,
+                          utils::vector_mm<char>& out, std::vector<unsigned long>& bools) const {
+          const size_t n = aut->num_states ();
+          auto fill = [&] (char* storage) {
+            int sum = 0;
+            for (size_t p = 0; p < split_at; ++p) {
+              storage[p] = out_of (p);
+              sum += storage[p];
+            }
+            return sum;
+          };
+
+          if constexpr (vectors::has_bitset<State>::value)
+            if (split_at < n) {
+              apply_bools (avec, dir, value_of, bools);
+              auto words = std::span<const unsigned long> (bools);
+              if constexpr (vectors::has_emplace<State, std::span<const unsigned long>, size_t>::value)
+                return State (vectors::emplace, split_at, fill, words, n - split_at);
+              else {
+                fill (out.data ());
+                return State (std::span<const char> (out.data (), split_at), words, n - split_at);
+              }
+            }
+
+          if constexpr (vectors::has_emplace<State>::value)
+            return State (vectors::emplace, n, fill);
+          else {
+            fill (out.data ());
+            return State (out);
+          }
+        }
+
+        // Computes the Boolean part of the result into bools, where
+        // value_of (s) is the value of state s in the input vector.
+        //   Forward: a Boolean state is reached (0) iff one of its sources is
+        //     not -1, so bools is the union of the successors of these.
+        //   Backward: a Boolean state stays 0 iff none of its successors p has
+        //     m[p] - accepting[p] < 0, so bools is the complement of the
+        //     union of the predecessors of these.
+        template <typename ValueOf>
+        void apply_bools (const action_vec& avec, direction dir, const ValueOf& value_of,
+                          std::vector<unsigned long>& bools) const {
+          std::fill (bools.begin (), bools.end (), 0);
+          const auto& rows = (dir == direction::forward) ? avec.bools_fwd : avec.bools_bwd;
+
+          for (unsigned r = 0; r < rows.count; ++r) {
+            const auto s = rows.states[r];
+            bool hit = (dir == direction::forward) ? (value_of (s) != -1) : (value_of (s) < accepting[s]);
+            if (hit) {
+              const auto* mask = rows.masks + r * bool_words;
+              for (size_t w = 0; w < bool_words; ++w)
+                bools[w] |= mask[w];
+            }
+          }
+
+          if (dir == direction::backward) {
+            for (auto& w : bools)
+              w = ~w;
+            const size_t nbools = aut->num_states () - split_at;
+            if (nbools % bits_per_word)
+              bools.back () &= (1ul << (nbools % bits_per_word)) - 1;
+          }
         }
 
-       private:
         const Aut& aut;
         char K;
         utils::vector_mm<char> apply_out, mcopy, backward_reset;
+        const size_t padded_n;
+        utils::vector_mm<char> bwd_t, bwd_out;
+        utils::vector_mm<char> block_in, block_out, block_t;
+        // States at and after split_at are in the bitset part of State.
+        const size_t split_at, bool_words;
+        std::vector<unsigned long> bool_out;
+        std::vector<char> accepting; // 1 if the state is accepting, 0 otherwise.
+        std::list<action_block> blocks;
         input_and_actions_set input_output_fwd_actions;
+        unsigned next_action_id = 0;
+        // Actions are interned: identical actions of different inputs are
+        // compiled once, and share their view and id.
+        std::map<raw_action_vec, action_vec> interned;
+        size_t all_actions = 0, pruned_actions = 0, kept_actions = 0;
+        size_t all_inputs = 0, dominated_inputs = 0;
+        // The inputs not compiled yet, with LAZY_ACTIONS.
+        using ios_iterator = decltype (std::declval<const IToIOs&> ().begin ());
+        std::optional<IToIOs> lazy_ios;
+        std::optional<ios_iterator> next_ios, end_ios;
+        std::set<raw_action_vecs> pulled_actions;
+        struct delta_memo {
+            std::vector<char> in, out;
+        };
+        std::vector<delta_memo> delta_memos; // Indexed by 2 * id + (dir == forward).
+        utils::clock_cache<apply_key, cached_apply, apply_key_hash> apply_cache {APPLY_CACHE_SIZE};
 
         template <typename Set>
         auto compute_action_vec (const Set& transset) {
-          action_vec ret_fwd (aut->num_states ());
-          TODO ("We have two representations of the same thing here; "
-                "see if we can narrow it down to one.");
+          raw_action_vec ret_fwd (aut->num_states ());
 
           for (const auto& [p, q] : transset)
-            ret_fwd[q].push_back (std::make_pair (p, aut->state_is_accepting (q)));
+            ret_fwd[q].push_back (p);
+          for (auto& sources : ret_fwd)
+            std::sort (sources.begin (), sources.end ());
 
           return ret_fwd;
         }
+
+        template <typename IOs>
+        raw_action_vecs raw_actions_of (const IOs& ios) {
+          raw_action_vecs fwd_actions;
+          for (const auto& transset : ios)
+            fwd_actions.push_back (compute_action_vec (transset));
+          all_actions += fwd_actions.size ();
+          pruned_actions += prune_subsumed (fwd_actions);
+          return fwd_actions;
+        }
+
+        void action_stats () {
+          verb_do (1, vout << "Subsumed actions pruned: " << pruned_actions
+                   /*   */ << "/" << all_actions << std::endl
+                   /*   */ << "Distinct actions: " << interned.size ()
+                   /*   */ << "/" << kept_actions << std::endl
+                   /*   */ << "Dominated inputs pruned: " << dominated_inputs
+                   /*   */ << "/" << all_inputs << std::endl);
+        }
+
+        // Whether the transitions of a are included in those of b.
+        bool included (const raw_action_vec& a, const raw_action_vec& b) const {
+          for (size_t q = 0; q < aut->num_states (); ++q)
+            if (not std::includes (b[q].begin (), b[q].end (), a[q].begin (), a[q].end ()))
+              return false;
+          return true;
+        }
+
+        // Whether an input with the actions weak yields, in cpre, a superset
+        // of what an input with the actions strong yields: each action of
+        // strong subsumes (see prune_subsumed) an action of weak.  The input
+        // weak is then never needed once strong is there.  In an input
+        // picker, if weak witnesses the one-step-loss of a vector, so does
+        // strong, as its forward images are larger.
+        bool weaker_input (const raw_action_vecs& weak, const raw_action_vecs& strong) const {
+          return std::all_of (strong.begin (), strong.end (), [&] (const auto& b) {
+            return std::any_of (weak.begin (), weak.end (), [&] (const auto& a) {
+              return included (a, b);
+            });
+          });
+        }
+
+        // Remove from ioset the inputs weaker than another, and return how
+        // many were removed.  Of inputs weaker than each other, the first
+        // one is kept.
+        template <typename IOSet>
+        size_t prune_dominated (IOSet& ioset) {
+          std::vector<typename IOSet::iterator> inputs;
+          for (auto it = ioset.begin (); it != ioset.end (); ++it)
+            inputs.push_back (it);
+          std::vector<bool> dominated (inputs.size (), false);
+          for (size_t i = 0; i < inputs.size (); ++i)
+            for (size_t j = 0; j < inputs.size () and not dominated[i]; ++j)
+              if (j != i and not dominated[j] and
+                  weaker_input (inputs[i]->second, inputs[j]->second) and
+                  (j < i or not weaker_input (inputs[j]->second, inputs[i]->second)))
+                dominated[i] = true;
+
+          size_t removed = 0;
+          for (size_t i = 0; i < inputs.size (); ++i)
+            if (dominated[i]) {
+              ioset.erase (inputs[i]);
+              removed++;
+            }
+          return removed;
+        }
+
+        // Remove the actions of an input whose transitions include those of
+        // another of its actions, and return how many were removed.  An action
+        // with fewer transitions has, for every vector, a larger backward image
+        // (the min over successors is over fewer values, the reset values and
+        // accepting flags being those of the states), and a smaller forward
+        // image.  So a removed action adds nothing to the union in cpre, and
+        // never succeeds in an input picker where the other action fails.  Of
+        // equal actions, the first one is kept.
+        size_t prune_subsumed (raw_action_vecs& raw_actions) {
+          std::vector<const raw_action_vec*> actions;
+          for (const auto& raw : raw_actions)
+            actions.push_back (&raw);
+          std::vector<bool> subsumed (actions.size (), false);
+          for (size_t i = 0; i < actions.size (); ++i)
+            for (size_t j = 0; j < actions.size () and not subsumed[i]; ++j)
+              if (j != i and included (*actions[j], *actions[i]) and
+                  (j < i or *actions[j] != *actions[i]))
+                subsumed[i] = true;
+
+          size_t i = 0, removed = 0;
+          for (auto it = raw_actions.begin (); it != raw_actions.end (); ++i)
+            if (subsumed[i]) {
+              it = raw_actions.erase (it);
+              removed++;
+            }
+            else
+              ++it;
+          return removed;
+        }
+
+        // Store the actions of an input that are not in interned in a new
+        // block, add them to interned, and return the views of all the actions.
+        action_vecs compile (const raw_action_vecs& all_raw_actions) {
+          std::vector<const raw_action_vec*> fresh;
+          for (const auto& raw : all_raw_actions)
+            if (interned.emplace (raw, action_vec {}).second)
+              fresh.push_back (&raw);
+
+          if (not fresh.empty ())
+            compile_block (fresh);
+
+          action_vecs ret;
+          for (const auto& raw : all_raw_actions)
+            ret.push_back (interned.at (raw));
+          kept_actions += all_raw_actions.size ();
+          return ret;
+        }
+
+        void compile_block (const std::vector<const raw_action_vec*>& raw_actions) {
+          const size_t n = aut->num_states ();
+          auto& block = blocks.emplace_back ();
+          block.offsets.reserve (raw_actions.size () * (n + 1));
+          for (const auto* raw_ptr : raw_actions) {
+            const auto& raw = *raw_ptr;
+            for (size_t q = 0; q < n; ++q) {
+              block.offsets.push_back (block.sources.size ());
+              block.sources.insert (block.sources.end (), raw[q].begin (), raw[q].end ());
+            }
+            block.offsets.push_back (block.sources.size ());
+          }
+
+          std::vector<std::pair<size_t, unsigned>> gather_pos_ranks;
+          for (const auto* raw : raw_actions)
+            gather_pos_ranks.push_back (compile_gather (*raw, block.gathers));
+
+          std::vector<std::array<unsigned, 4>> bool_rows_pos;
+          for (const auto* raw : raw_actions)
+            bool_rows_pos.push_back (compile_bools (*raw, block));
+
+          if constexpr (DELTA_APPLY_MAX > 0)
+            for (const auto* raw : raw_actions) {
+              std::vector<std::vector<unsigned>> succs (n);
+              for (size_t p = 0; p < n; ++p)
+                for (auto q : (*raw)[p])
+                  succs[q].push_back (p);
+              for (size_t q = 0; q < n; ++q) {
+                block.succ_offsets.push_back (block.succs.size ());
+                block.succs.insert (block.succs.end (), succs[q].begin (), succs[q].end ());
+              }
+              block.succ_offsets.push_back (block.succs.size ());
+            }
+
+          // The block is complete, so the views can now point into it.
+          auto rows_at = [&] (unsigned start, unsigned count) {
+            return bool_rows {block.bool_states.data () + start,
+                              block.bool_masks.data () + start * bool_words,
+                              count};
+          };
+          for (size_t j = 0; j < raw_actions.size (); ++j) {
+            auto [pos, ranks] = gather_pos_ranks[j];
+            auto [fwd_start, fwd_count, bwd_start, bwd_count] = bool_rows_pos[j];
+            interned.at (*raw_actions[j]) = {block.offsets.data () + j * (n + 1), block.sources.data (),
+                                             ranks ? block.gathers.data () + pos : nullptr, ranks,
+                                             rows_at (fwd_start, fwd_count), rows_at (bwd_start, bwd_count),
+                                             block.succ_offsets.data () + j * (n + 1), block.succs.data (),
+                                             next_action_id++};
+          }
+          if constexpr (DELTA_APPLY_MAX > 0)
+            delta_memos.resize (2 * next_action_id);
+        }
+
+        // Append the rows of apply_bools for an action to the block, and return
+        // the first row and number of rows, forward then backward.
+        std::array<unsigned, 4> compile_bools (const raw_action_vec& raw, action_block& block) {
+          const size_t n = aut->num_states ();
+          std::array<unsigned, 4> ret {};
+          if (split_at == n)
+            return ret;
+
+          auto add_rows = [&] (const std::vector<std::vector<unsigned long>>& rows,
+                               unsigned& start, unsigned& count) {
+            start = block.bool_states.size ();
+            for (size_t s = 0; s < n; ++s)
+              if (not rows[s].empty ()) {
+                block.bool_states.push_back (s);
+                block.bool_masks.insert (block.bool_masks.end (), rows[s].begin (), rows[s].end ());
+              }
+            count = block.bool_states.size () - start;
+          };
+
+          auto set_bit = [&] (std::vector<unsigned long>& row, size_t b) {
+            if (row.empty ())
+              row.resize (bool_words, 0);
+            row[b / bits_per_word] |= 1ul << (b % bits_per_word);
+          };
+
+          std::vector<std::vector<unsigned long>> fwd (n), bwd (n);
+          for (size_t p = 0; p < n; ++p)
+            for (auto q : raw[p]) {
+              if (p >= split_at) // q -> p, p Boolean: p is a successor of q.
+                set_bit (fwd[q], p - split_at);
+              if (q >= split_at) // q -> p, q Boolean: q is a predecessor of p.
+                set_bit (bwd[p], q - split_at);
+            }
+
+          add_rows (fwd, ret[0], ret[1]);
+          add_rows (bwd, ret[2], ret[3]);
+          return ret;
+        }
+
+        // Append the gather tables of an action to gathers, and return their
+        // position and number.  Actions where some state has many more
+        // successors than the average get no tables (0 ranks), as the tables
+        // would be mostly padding; they use the CSR arrays instead.
+        std::pair<size_t, unsigned> compile_gather (const raw_action_vec& raw,
+                                                    std::vector<uint16_t>& gathers) {
+          const size_t n = aut->num_states ();
+          if (n >= std::numeric_limits<uint16_t>::max ())
+            return {0, 0};
+
+          std::vector<std::vector<uint16_t>> succs (n);
+          size_t ntrans = 0;
+          for (size_t p = 0; p < n; ++p)
+            for (auto q : raw[p]) {
+              succs[q].push_back (p);
+              ntrans++;
+            }
+
+          size_t ranks = 0;
+          for (const auto& s : succs)
+            ranks = std::max (ranks, s.size ());
+          if (ranks == 0 or ranks * padded_n > 4 * (ntrans + padded_n))
+            return {0, 0};
+
+          size_t pos = gathers.size ();
+          gathers.resize (pos + ranks * padded_n, n);
+          for (size_t q = 0; q < n; ++q)
+            for (size_t r = 0; r < succs[q].size (); ++r)
+              gathers[pos + r * padded_n + q] = succs[q][r];
+          return {pos, ranks};
+        }
     };
   }
 
@@ -46,10 +46,10 @@
 #ifdef NO_SIMD
 # pragma message ("Compiling without SIMD")
 # ifndef ARRAY_IMPL
-#  define ARRAY_IMPL array_backed_sum
+#  define ARRAY_IMPL swar_array_backed_sum
 # endif
 # ifndef VECTOR_IMPL
-#  define VECTOR_IMPL vector_backed
+#  define VECTOR_IMPL swar_vector_backed
 # endif
 #else
 # pragma message ("Compiling with SIMD")
@@ -61,6 +61,65 @@
 # endif
 #endif
 
+// Round the static capacities and bitset counts up to a few buckets (see
+// utils/buckets.hh) rather than instantiating the solver for each value.
+#ifndef CAPACITY_BUCKETS
+# define CAPACITY_BUCKETS true
+#endif
+
+// Fixed-size SIMD vectors that fit in at most this many registers use fully
+// unrolled kernels.  Set to 0 to disable.
+#ifndef SIMD_UNROLL_MAX
+# define SIMD_UNROLL_MAX 2
+#endif
+
+// Number of results of actioners::standard::apply kept for reuse, as the
+// elements of the antichain are often applied the same actions at each
+// iteration.  Set to 0 to disable.
+#ifndef APPLY_CACHE_SIZE
+# define APPLY_CACHE_SIZE 0
+#endif
+
+// Results of actioners::standard::apply are updated from the last result
+// for the same action when the input vectors differ in at most this many
+// coordinates.  This replaces the gather kernel for these inputs, and still
+// reads the whole input, so it only pays on actions with many transitions
+// per state.  The downsets applied by block keep the block kernel.  Set to 0
+// to disable.
+#ifndef DELTA_APPLY_MAX
+# define DELTA_APPLY_MAX 0
+#endif
+
+// If set, actioners::standard compiles the actions of an input only when
+// an input picker runs out of compiled inputs, rather than all upfront.
+#ifndef LAZY_ACTIONS
+# define LAZY_ACTIONS 0
+#endif
+
+// If set, symmetries of the automaton that swap inputs are detected, and the
+// input picker only considers a representative of each orbit of inputs.
+#ifndef SYMMETRY
+# define SYMMETRY 0
+#endif
+
+// Number of processes used by ios_precomputers::powset to refine the
+// transition labels; 0 uses one per core.
+#ifndef POWSET_WORKERS
+# define POWSET_WORKERS 1
+#endif
+
+// Number of threads used by input_pickers::critical_par to search for a
+// critical input; 0 uses one per core.
+#ifndef PICKER_WORKERS
+# define PICKER_WORKERS 0
+#endif
+
+// If set, while the cpre for an input is computed, another thread looks for
+// the next critical input in the previous F (see input_pickers::speculator).
+#ifndef PIPELINE
+# define PIPELINE 0
+#endif
+
 #ifndef ARRAY_AND_BITSET_DOWNSET_IMPL
 # define ARRAY_AND_BITSET_DOWNSET_IMPL vector_backed_bin
 #endif
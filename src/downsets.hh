@@ -1,7 +1,33 @@
 #pragma once
 
+#include <span>
+#include <type_traits>
+#include <vector>
+
 #include "configuration.hh"
 
+namespace downsets {
+  // Downsets implementing apply_by_block (f) call f on blocks of their
+  // elements, as a std::span, and build the result from the vectors it returns.
+  template <class T, class = void>
+  struct has_apply_by_block : std::false_type {};
+
+  template <class T>
+  struct has_apply_by_block<T, std::void_t<decltype (std::declval<const T&> ().apply_by_block (
+                                                       std::declval<std::vector<typename T::value_type> (*) (
+                                                         std::span<const typename T::value_type>)> ()))>> : std::true_type {};
+
+  // Downsets implementing contains_any (span) check several vectors for
+  // membership in one pass, returning the position of one that is in the
+  // downset, or the size of the span if there is none.
+  template <class T, class = void>
+  struct has_contains_any : std::false_type {};
+
+  template <class T>
+  struct has_contains_any<T, std::void_t<decltype (std::declval<const T&> ().contains_any (
+                                                     std::declval<std::span<const typename T::value_type>> ()))>> : std::true_type {};
+}
+
 #include "downsets/full_set.hh"
 #include "downsets/kdtree_backed.hh"
 #include "downsets/vector_backed.hh"
@@ -5,6 +5,7 @@
 #include <set>
 #include <iostream>
 #include <cassert>
+#include <span>
 
 namespace downsets {
   template <typename Vector>
@@ -116,6 +117,16 @@ namespace downsets {
         return res;
       }
 
+      // Same as apply, but block_lambda maps the whole set, as a span, to a
+      // vector of results.
+      template <typename F>
+      vector_backed apply_by_block (const F& block_lambda) const {
+        vector_backed res;
+        for (auto&& el : block_lambda (std::span<const Vector> (vector_set)))
+          res.insert (std::move (el));
+        return res;
+      }
+
       template <typename F>
       void apply_inplace (const F& lambda) {
         std::vector<Vector> new_set;
@@ -7,6 +7,7 @@
 #include <cassert>
 #include <sstream>
 #include <cstdlib>
+#include <span>
 
 #include "vectors.hh"
 
@@ -46,6 +47,34 @@ namespace downsets {
         return false;
       }
 
+      // Same as contains, on several vectors at once: returns the position of
+      // one of the vectors of vs that is in the downset, or vs.size () if
+      // there is none.  The queries are sorted by bin, and the bins are
+      // scanned once, from the last: each element of bin b is compared to all
+      // the queries of bin at most b.
+      size_t contains_any (std::span<const Vector> vs) const {
+        std::vector<std::pair<size_t, size_t>> queries; // (bin, position)
+        queries.reserve (vs.size ());
+        for (size_t i = 0; i < vs.size (); ++i)
+          if (bin_of (vs[i]) < vector_set.size ())
+            queries.emplace_back (bin_of (vs[i]), i);
+        std::sort (queries.begin (), queries.end ());
+
+        // The queries of bin at most b are the first active ones.
+        size_t active = queries.size ();
+        for (size_t b = vector_set.size (); b-- > 0; ) {
+          while (active > 0 and queries[active - 1].first > b)
+            --active;
+          if (active == 0)
+            break;
+          for (const auto& e : vector_set[b])
+            for (size_t j = 0; j < active; ++j)
+              if (vs[queries[j].second].partial_order (e).leq ())
+                return queries[j].second;
+        }
+        return vs.size ();
+      }
+
       auto size () const {
         return _size;
       }
@@ -167,6 +196,21 @@ namespace downsets {
         return res;
       }
 
+      // Same as apply, but block_lambda maps a whole bin, as a span, to a
+      // vector of results.
+      template <typename F>
+      vector_backed_bin apply_by_block (const F& block_lambda) const {
+        vector_backed_bin res (vector_set.size ());
+        for (auto& elvec : vector_set) {
+          if (elvec.empty ())
+            continue;
+          for (auto&& el : block_lambda (std::span<const Vector> (elvec)))
+            res.insert (std::move (el));
+        }
+
+        return res;
+      }
+
       // template <typename T>
       // struct const_iterator {
       //     const_iterator (const T& vs, bool end) :
@@ -1,8 +1,24 @@
 #pragma once
 
+#include <type_traits>
+
 #include "configuration.hh"
 
+namespace input_pickers {
+  // Input pickers implementing used (input, F_size) are told when the
+  // solver uses an input that they did not pick, see speculator.
+  template <class T, class = void>
+  struct has_used : std::false_type {};
+
+  template <class T>
+  struct has_used<T, std::void_t<decltype (&T::used)>> : std::true_type {};
+}
+
 #include "input_pickers/critical.hh"
 #include "input_pickers/critical_pq.hh"
+#include "input_pickers/critical_incr.hh"
+#include "input_pickers/critical_par.hh"
+#include "input_pickers/critical_bandit.hh"
+#include "input_pickers/speculator.hh"
 #include "input_pickers/critical_rnd.hh"
 #include "input_pickers/critical_fullrnd.hh"
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include "actioners.hh"
+#include "downsets.hh"
+
+namespace input_pickers {
+  namespace detail {
+    // Returns an action of actions whose forward image of f is in F, or
+    // actions.end () if there is none, that is, if input witnesses the
+    // one-step-loss of f.  If F can check several vectors at once, the first
+    // action, usually the one found last time, is tried alone, then the
+    // images by all the other actions are computed and checked together.
+    template <typename SetOfStates, typename Input, typename Actions, typename Actioner>
+    auto action_into (const SetOfStates& F, const typename SetOfStates::value_type& f,
+                      const Input& input, Actions& actions, Actioner& actioner) {
+      auto image_in_F = [&] (const auto& action) {
+        auto fwdf = actioner.apply (f, action, actioners::direction::forward);
+        bool in_F = F.contains (fwdf);
+        verb_do (3, vout << "apply(" << f << ", <" << input << ", ?>) = " << fwdf << ": "
+                 /*   */ << (in_F ? " is in F." : " is not in F.") << std::endl);
+        return in_F;
+      };
+
+      if constexpr (downsets::has_contains_any<SetOfStates>::value) {
+        if (actions.empty () or image_in_F (actions.front ()))
+          return actions.begin ();
+        std::vector<typename SetOfStates::value_type> images;
+        for (auto it = std::next (actions.begin ()); it != actions.end (); ++it)
+          images.push_back (actioner.apply (f, *it, actioners::direction::forward));
+        return std::next (actions.begin (), 1 + F.contains_any (images));
+      }
+      else
+        return std::find_if (actions.begin (), actions.end (), image_in_F);
+    }
+  }
+}
@@ -3,6 +3,8 @@
 #include <random>
 #include <optional>
 #include "actioners.hh"
+#include "input_pickers/action_into.hh"
+#include "input_pickers/pull_critical.hh"
 
 namespace input_pickers {
   namespace detail {
@@ -35,18 +37,8 @@ namespace input_pickers {
 
             for (auto it = Cbar.begin (); it != Cbar.end (); ++it) {
               auto& [input, actions] = it->get ();
-              is_witness = true;
-              auto it_act = actions.begin ();
-              for (; it_act != actions.end (); ++it_act) {
-                auto fwdf = actioner.apply (f, *it_act, actioners::direction::forward);
-                verb_do (3, vout << "apply(" << f << ", <" << input << ", ?>) = " << fwdf << ": ");
-                if (F.contains (fwdf)) {
-                  verb_do (3, vout << " is in F." << std::endl);
-                  is_witness = false;
-                  break;
-                }
-                verb_do (3, vout << " is not in F." << std::endl);
-              }
+              auto it_act = action_into (F, f, input, actions, actioner);
+              is_witness = (it_act == actions.end ());
 
               if (is_witness) {
                 // inputs witness one-step-loss of f
@@ -65,6 +57,8 @@ namespace input_pickers {
           }
 
           if (critical_input == Cbar.end ()) {
+            if (auto* pulled = pull_critical (F, actioner, [] (auto&) {}))
+              return std::make_optional (input_and_actions_ref (*pulled));
             verb_do (3, vout << "No critical input." << std::endl);
             return std::optional<input_and_actions_ref> ();
           }
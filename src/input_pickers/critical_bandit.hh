@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <vector>
+#include "actioners.hh"
+#include "input_pickers/action_into.hh"
+#include "input_pickers/pull_critical.hh"
+
+namespace input_pickers {
+  namespace detail {
+    template <typename FwdActions, typename Actioner>
+    struct critical_bandit {
+      public:
+        critical_bandit (FwdActions& fwd_actions, Actioner& actioner) :
+          actioner {actioner}, K {actioner.getK ()} {
+          for (auto& el : fwd_actions)
+            add_input (el);
+        }
+
+        template <typename SetOfStates>
+        auto operator() (const SetOfStates& F) {
+          // The inputs are the arms of a multi-armed bandit, picked with UCB1.
+          // The reward of an input is the shrinkage of F that its cpre gave,
+          // per second, relative to the best seen so far; the time is that
+          // between two calls, which is mostly the cpre.  When K changes, F is
+          // changed by the solver, so no reward is given, but the scores are
+          // kept.
+          //
+          // The shrinkage is measured on the number of maximal elements of F,
+          // which is only a proxy: the downset can shrink while its antichain
+          // keeps its size or grows, when an element is replaced by several
+          // smaller ones.  Such a cpre gets a reward of 0, never less.
+          reward (F.size ());
+
+          // For the first element of F that has a witness of its one-step-loss,
+          // all the inputs are checked, and the witness with the best score
+          // is picked.
+          std::optional<size_t> best;
+          for (const auto& f : F) {
+            for (size_t i = 0; i < inputs.size (); ++i) {
+              auto& [input, actions] = inputs[i].get ();
+              if (action_into (F, f, input, actions, actioner) != actions.end ())
+                continue;
+              verb_do (3, vout << "Input " << input
+                       /*   */ << " witnesses one-step-loss of " << f << std::endl);
+              if (not best or score (i) > score (*best))
+                best = i;
+            }
+            if (best)
+              break;
+          }
+
+          if (not best) {
+            auto pulled = pull_critical (F, actioner, [this] (auto& el) { add_input (el); });
+            if (not pulled) {
+              verb_do (3, vout << "No critical input." << std::endl);
+              return std::optional<input_and_actions_ref> ();
+            }
+            best = inputs.size () - 1;
+          }
+
+          verb_do (2, vout << "Critical input: [" << inputs[*best].get ().first << "] "
+                   /*   */ << "(pulled " << arms[*best].pulls << " times)" << std::endl);
+          pull (*best, F.size ());
+          return std::make_optional (inputs[*best]);
+        }
+
+        // The solver used input without calling the picker, F being of size
+        // F_size (see speculator): the next reward goes to that input.
+        void used (std::reference_wrapper<typename FwdActions::value_type> input, size_t F_size) {
+          reward (F_size);
+          last.reset ();
+          for (size_t i = 0; i < inputs.size (); ++i)
+            if (&inputs[i].get () == &input.get ())
+              pull (i, F_size);
+        }
+
+      private:
+        using input_and_actions_ref = std::reference_wrapper<typename FwdActions::value_type>;
+
+        struct arm {
+            size_t pulls = 0, rewarded = 0;
+            double sum = 0;
+        };
+
+        Actioner& actioner;
+        int K;
+        std::vector<input_and_actions_ref> inputs;
+        std::vector<arm> arms;
+        size_t total_pulls = 0;
+        double best_rate = 0;
+
+        // The input returned by the previous call, and F at that time.
+        std::optional<size_t> last;
+        size_t last_size = 0;
+        std::chrono::steady_clock::time_point last_time;
+
+        void add_input (typename FwdActions::value_type& el) {
+          inputs.push_back (std::ref (el));
+          arms.emplace_back ();
+        }
+
+        void pull (size_t i, size_t F_size) {
+          arms[i].pulls++;
+          total_pulls++;
+          last = i;
+          last_size = F_size;
+          last_time = std::chrono::steady_clock::now ();
+        }
+
+        void reward (size_t F_size) {
+          if (actioner.getK () != K) {
+            K = actioner.getK ();
+            last.reset ();
+          }
+          if (not last)
+            return;
+          auto seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - last_time).count ();
+          double shrinkage = (last_size > F_size) ? (double) (last_size - F_size) / last_size : 0;
+          double rate = shrinkage / std::max (seconds, 1e-9);
+          best_rate = std::max (best_rate, rate);
+          auto& a = arms[*last];
+          a.sum += (best_rate > 0) ? std::clamp (rate / best_rate, 0., 1.) : 0;
+          a.rewarded++;
+        }
+
+        // UCB1: inputs that were not rewarded yet go first.
+        double score (size_t i) const {
+          const auto& a = arms[i];
+          if (a.rewarded == 0)
+            return std::numeric_limits<double>::infinity ();
+          return a.sum / a.rewarded + std::sqrt (2 * std::log ((double) total_pulls) / a.rewarded);
+        }
+    };
+  }
+
+  struct critical_bandit {
+      template <typename FwdActions, typename Actioner>
+      static auto make (FwdActions& fwd_actions, Actioner& actioner) {
+        return detail::critical_bandit (fwd_actions, actioner);
+      }
+  };
+}
@@ -3,6 +3,7 @@
 #include <random>
 #include <optional>
 #include "actioners.hh"
+#include "input_pickers/pull_critical.hh"
 
 namespace input_pickers {
   namespace detail {
@@ -67,6 +68,8 @@ namespace input_pickers {
           }
 
           if (critical_input == Cbar.end ()) {
+            if (auto* pulled = pull_critical (F, actioner, [] (auto&) {}))
+              return std::make_optional (input_and_actions_ref (*pulled));
             verb_do (3, vout << "No critical input." << std::endl);
             return std::optional<input_and_actions_ref> ();
           }
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "actioners.hh"
+#include "input_pickers/pull_critical.hh"
+
+namespace input_pickers {
+  namespace detail {
+    template <typename Apply>
+    struct apply_result;
+
+    template <typename Actioner, typename R, typename... Args>
+    struct apply_result<R (Actioner::*) (Args...)> {
+        using type = R;
+    };
+
+    template <typename FwdActions, typename Actioner>
+    struct critical_incr {
+      public:
+        critical_incr (FwdActions& fwd_actions, Actioner& actioner) :
+          actioner {actioner}, K {actioner.getK ()} {
+          for (auto& el : fwd_actions)
+            add_input (el);
+        }
+
+        template <typename SetOfStates>
+        auto operator() (const SetOfStates& F) {
+          // Same search as critical_pq, but the forward image of f that is
+          // found in F for each input is kept as a certificate that the input
+          // does not witness the one-step-loss of f.  Between two calls, F
+          // only shrinks, so the certificate holds as long as it is in F; only
+          // the new elements of F, and the inputs whose certificate left F,
+          // are checked again.  The forward images depend on K, so the
+          // certificates are dropped when it changes.
+          if (actioner.getK () != K) {
+            K = actioner.getK ();
+            certificates.clear ();
+          }
+          else if (certificates.size () > 2 * F.size ())
+            forget_removed (F);
+
+          for (const auto& f : F) {
+            auto& certs = certificates[key_of (f)];
+            certs.resize (inputs.size ());
+
+            for (auto i : order) {
+              auto& cert = certs[i];
+              checked++;
+              if (cert and F.contains (*cert))
+                continue;
+              rechecked++;
+              cert.reset ();
+
+              auto& [input, actions] = inputs[i].get ();
+              for (auto it_act = actions.begin (); it_act != actions.end (); ++it_act) {
+                auto fwdf = actioner.apply (f, *it_act, actioners::direction::forward);
+                if (F.contains (fwdf)) {
+                  cert.emplace (std::move (fwdf));
+                  if (it_act != actions.begin ())
+                    actions.splice (actions.begin (), actions, it_act);
+                  break;
+                }
+              }
+
+              if (not cert) {
+                verb_do (3, vout << "Input " << input
+                         /*   */ << " witnesses one-step-loss of " << f << std::endl);
+                // Critical inputs are tried first.
+                hits[i]++;
+                std::stable_sort (order.begin (), order.end (),
+                                  [this] (size_t a, size_t b) { return hits[a] > hits[b]; });
+                verb_do (2, vout << "Critical input: [" << input << "] " << std::endl);
+                return std::make_optional (inputs[i]);
+              }
+            }
+          }
+
+          auto pulled = pull_critical (F, actioner, [this] (auto& el) { add_input (el); });
+          if (pulled)
+            return std::make_optional (input_and_actions_ref (*pulled));
+
+          verb_do (3, vout << "No critical input." << std::endl);
+          return std::optional<input_and_actions_ref> ();
+        }
+
+        ~critical_incr () {
+          verb_do (1, vout << "Certificates rechecked: " << rechecked
+                   /*   */ << "/" << checked << std::endl);
+        }
+
+      private:
+        using input_and_actions_ref = std::reference_wrapper<typename FwdActions::value_type>;
+        using State = typename apply_result<decltype (&Actioner::apply)>::type;
+
+        Actioner& actioner;
+        int K;
+        std::vector<input_and_actions_ref> inputs;
+        std::vector<size_t> hits, order; // Inputs are scanned by decreasing hits.
+        // For each element of F, and each input, the forward image found in F.
+        std::unordered_map<std::string, std::vector<std::optional<State>>> certificates;
+        size_t checked = 0, rechecked = 0;
+
+        void add_input (typename FwdActions::value_type& el) {
+          order.push_back (inputs.size ());
+          inputs.push_back (std::ref (el));
+          hits.push_back (0);
+        }
+
+        template <typename S>
+        static std::string key_of (const S& f) {
+          std::string key (f.size (), 0);
+          for (size_t i = 0; i < f.size (); ++i)
+            key[i] = f[i];
+          return key;
+        }
+
+        template <typename SetOfStates>
+        void forget_removed (const SetOfStates& F) {
+          decltype (certificates) kept;
+          for (const auto& f : F) {
+            auto it = certificates.find (key_of (f));
+            if (it != certificates.end ())
+              kept.emplace (std::move (*it));
+          }
+          certificates = std::move (kept);
+        }
+    };
+  }
+
+  struct critical_incr {
+      template <typename FwdActions, typename Actioner>
+      static auto make (FwdActions& fwd_actions, Actioner& actioner) {
+        return detail::critical_incr (fwd_actions, actioner);
+      }
+  };
+}
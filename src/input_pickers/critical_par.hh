@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "actioners.hh"
+#include "input_pickers/pull_critical.hh"
+
+namespace input_pickers {
+  namespace detail {
+    // The workers are started once, with the picker, and wait for each call
+    // in worker_loop.  The calling thread acts as worker 0.
+    template <typename FwdActions, typename Actioner>
+    struct critical_par {
+      public:
+        critical_par (FwdActions& fwd_actions, Actioner& actioner) :
+          actioner {actioner},
+          nworkers {PICKER_WORKERS ? PICKER_WORKERS : std::max (1u, std::thread::hardware_concurrency ())} {
+          for (auto& el : fwd_actions)
+            fwd_actions_pq.emplace (next_priority++, std::ref (el));
+          for (size_t w = 0; w < nworkers; ++w)
+            worker_buffers.push_back (actioner.make_buffers ());
+          for (size_t w = 1; w < nworkers; ++w)
+            pool.emplace_back ([this, w] { worker_loop (w); });
+        }
+
+        // The workers point to this.
+        critical_par (const critical_par&) = delete;
+
+        ~critical_par () {
+          {
+            std::lock_guard lock (pool_mutex);
+            quit = true;
+          }
+          wake.notify_all ();
+          for (auto& t : pool)
+            t.join ();
+        }
+
+        template <typename SetOfStates>
+        auto operator() (const SetOfStates& F) {
+          // Returns the same input as critical_pq: the first input, by
+          // priority, that witnesses the one-step-loss of the first element
+          // of F that has a witness.  The elements are handed out to the
+          // workers in chunks, in order.  A worker that finds a witness lowers
+          // found, and the elements after found are skipped, so all the
+          // elements before the answer are still checked.
+          using State = typename SetOfStates::value_type;
+          std::vector<const State*> elements;
+          for (const auto& f : F)
+            elements.push_back (&f);
+          std::vector<typename fwd_actions_pq_t::iterator> inputs;
+          for (auto it = fwd_actions_pq.begin (); it != fwd_actions_pq.end (); ++it)
+            inputs.push_back (it);
+
+          constexpr size_t none = std::numeric_limits<size_t>::max ();
+          const size_t chunk = std::clamp (elements.size () / (8 * nworkers), 1ul, 64ul);
+          std::atomic<size_t> next {0}, found {none};
+          // For each worker, the element and input it found.
+          std::vector<std::pair<size_t, size_t>> results (nworkers, {none, none});
+
+          auto work = [&] (size_t w) {
+            auto& buf = worker_buffers[w];
+            for (size_t start = next.fetch_add (chunk);
+                 start < elements.size () and start < found.load ();
+                 start = next.fetch_add (chunk))
+              for (size_t e = start; e < std::min (start + chunk, elements.size ()); ++e) {
+                if (e >= found.load ())
+                  return;
+                for (size_t k = 0; k < inputs.size (); ++k) {
+                  const auto& [input, actions] = inputs[k]->second.get ();
+                  if (std::none_of (actions.begin (), actions.end (), [&] (const auto& action) {
+                        return F.contains (actioner.apply_forward (*elements[e], action, buf));
+                      })) {
+                    results[w] = {e, k};
+                    size_t cur = found.load ();
+                    while (e < cur and not found.compare_exchange_weak (cur, e))
+                      continue;
+                    // The next elements of this worker come after e.
+                    return;
+                  }
+                }
+              }
+          };
+
+          if (nworkers == 1 or elements.size () <= chunk)
+            work (0);
+          else
+            run (work);
+
+          auto [e, k] = *std::min_element (results.begin (), results.end ());
+          if (e == none) {
+            auto pulled = pull_critical (F, actioner, [this] (auto& el) {
+              fwd_actions_pq.emplace (next_priority++, std::ref (el));
+            });
+            if (pulled)
+              return std::make_optional (input_and_actions_ref (*pulled));
+            verb_do (3, vout << "No critical input." << std::endl);
+            return std::optional<input_and_actions_ref> ();
+          }
+
+          // Update the hit count of that critical input.
+          auto [priority, ref] = *inputs[k];
+          fwd_actions_pq.erase (inputs[k]);
+          fwd_actions_pq.emplace (priority - 1, ref);
+
+          verb_do (2, vout << "Critical input: [" << ref.get ().first << "] "
+                   /*   */ << "for " << *elements[e] << std::endl);
+
+          return std::make_optional (ref);
+        }
+      private:
+        using input_and_actions_ref = std::reference_wrapper<typename FwdActions::value_type>;
+        using fwd_actions_pq_t = std::multimap<int, input_and_actions_ref>; // needs to be signed
+        fwd_actions_pq_t fwd_actions_pq;
+        int next_priority = 0;
+        Actioner& actioner;
+        const size_t nworkers;
+        std::vector<typename Actioner::buffers> worker_buffers;
+
+        std::vector<std::thread> pool;
+        std::mutex pool_mutex;
+        std::condition_variable wake, done;
+        std::function<void (size_t)> job;
+        size_t round = 0, running = 0;
+        bool quit = false;
+
+        // Runs job (w) on every worker w, and returns once they are all done.
+        void run (std::function<void (size_t)> f) {
+          {
+            std::lock_guard lock (pool_mutex);
+            job = std::move (f);
+            running = nworkers - 1;
+            ++round;
+          }
+          wake.notify_all ();
+          job (0);
+          std::unique_lock lock (pool_mutex);
+          done.wait (lock, [this] { return running == 0; });
+        }
+
+        void worker_loop (size_t w) {
+          size_t seen = 0;
+          std::unique_lock lock (pool_mutex);
+          while (true) {
+            wake.wait (lock, [&] { return quit or round != seen; });
+            if (quit)
+              return;
+            seen = round;
+            lock.unlock ();
+            job (w);
+            lock.lock ();
+            if (--running == 0)
+              done.notify_one ();
+          }
+        }
+   };
+  }
+
+  struct critical_par {
+      template <typename FwdActions, typename Actioner>
+      static auto make (FwdActions& fwd_actions, Actioner& actioner) {
+        return detail::critical_par (fwd_actions, actioner);
+      }
+  };
+}
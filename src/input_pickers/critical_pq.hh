@@ -3,6 +3,8 @@
 #include <random>
 #include <optional>
 #include "actioners.hh"
+#include "input_pickers/action_into.hh"
+#include "input_pickers/pull_critical.hh"
 
 namespace input_pickers {
   namespace detail {
@@ -11,9 +13,8 @@ namespace input_pickers {
       public:
         critical_pq (FwdActions& fwd_actions, Actioner& actioner) :
           actioner {actioner}, gen {0} {
-          int priority = 0;
           for (auto& el : fwd_actions)
-            fwd_actions_pq.emplace (priority++, std::ref (el));
+            fwd_actions_pq.emplace (next_priority++, std::ref (el));
         }
 
         template <typename SetOfStates>
@@ -33,18 +34,8 @@ namespace input_pickers {
 
             for (auto it = fwd_actions_pq.begin (); it != fwd_actions_pq.end (); ++it) {
               auto& [input, actions] = it->second.get ();
-              is_witness = true;
-              auto it_act = actions.begin ();
-              for (/* */; it_act != actions.end (); ++it_act) {
-                auto fwdf = actioner.apply (f, *it_act, actioners::direction::forward);
-                verb_do (3, vout << "apply(" << f << ", <" << input << ", ?>) = " << fwdf << ": ");
-                if (F.contains (fwdf)) {
-                  verb_do (3, vout << " is in F." << std::endl);
-                  is_witness = false;
-                  break;
-                }
-                verb_do (3, vout << " is not in F." << std::endl);
-              }
+              auto it_act = action_into (F, f, input, actions, actioner);
+              is_witness = (it_act == actions.end ());
 
               if (is_witness) {
                 // inputs witness one-step-loss of f
@@ -63,6 +54,12 @@ namespace input_pickers {
           }
 
           if (critical_input == fwd_actions_pq.end ()) {
+            // Inputs compiled on demand go after the others.
+            auto pulled = pull_critical (F, actioner, [this] (auto& el) {
+              fwd_actions_pq.emplace (next_priority++, std::ref (el));
+            });
+            if (pulled)
+              return std::make_optional (input_and_actions_ref (*pulled));
             verb_do (3, vout << "No critical input." << std::endl);
             return std::optional<input_and_actions_ref> ();
           }
@@ -86,6 +83,7 @@ namespace input_pickers {
         using input_and_actions_ref = std::reference_wrapper<typename FwdActions::value_type>;
         using fwd_actions_pq_t = std::multimap<int, input_and_actions_ref>; // needs to be signed
         fwd_actions_pq_t fwd_actions_pq;
+        int next_priority = 0;
         Actioner& actioner;
         std::mt19937 gen;
    };
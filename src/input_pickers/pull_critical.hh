@@ -0,0 +1,33 @@
+#pragma once
+
+#include <algorithm>
+#include "actioners.hh"
+
+namespace input_pickers {
+  namespace detail {
+    // With an actioner that compiles its inputs on demand, once no compiled
+    // input is critical for F, the inputs left are compiled one by one until
+    // one witnesses the one-step-loss of an element of F.  Returns that input,
+    // or nullptr if there is none.  Each compiled input is passed to on_pull.
+    template <typename SetOfStates, typename Actioner, typename OnPull>
+    auto pull_critical (const SetOfStates& F, Actioner& actioner, OnPull&& on_pull) {
+      using input_and_actions = typename Actioner::input_and_actions;
+
+      if constexpr (actioners::has_lazy_inputs<Actioner>::value)
+        while (input_and_actions* pulled = actioner.pull_input ()) {
+          on_pull (*pulled);
+          const auto& [input, actions] = *pulled;
+          for (const auto& f : F)
+            if (std::none_of (actions.begin (), actions.end (), [&] (const auto& action) {
+                  return F.contains (actioner.apply (f, action, actioners::direction::forward));
+                })) {
+              verb_do (3, vout << "Input " << input
+                       /*   */ << " witnesses one-step-loss of " << f << std::endl);
+              return pulled;
+            }
+        }
+
+      return (input_and_actions*) nullptr;
+    }
+  }
+}
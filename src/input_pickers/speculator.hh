@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <utility>
+#include "actioners.hh"
+
+namespace input_pickers {
+  // Looks for the next critical input while the solver computes the cpre,
+  // with PIPELINE.  The cpre only reads F until the final intersection, so
+  // start (F, input) searches F in a thread until stop () is called, right
+  // before F is changed.  The search uses apply_forward, which only reads
+  // the actioner, so it can run alongside the backward applies.
+  //
+  // An input found for f in the old F is still critical for the new F if f
+  // is in it: the new F is included in the old one, so the forward images of
+  // f that were not in the old F are not in the new one either.
+  template <typename FwdActions, typename Actioner, typename SetOfStates>
+  class speculator {
+    public:
+      using input_and_actions_ref = std::reference_wrapper<typename FwdActions::value_type>;
+
+      speculator (FwdActions& fwd_actions, Actioner& actioner) :
+        fwd_actions {fwd_actions}, actioner {actioner}, buf {actioner.make_buffers ()} {}
+
+      void start (const SetOfStates& F, const typename FwdActions::value_type& current) {
+        found.reset ();
+        witness.reset ();
+        K = actioner.getK ();
+        stopped = false;
+        worker = std::thread ([this, &F, &current] { search (F, current); });
+      }
+
+      void stop () {
+        stopped = true;
+        worker.join ();
+      }
+
+      // The input found by the last search, if it is still critical for F.
+      std::optional<input_and_actions_ref> next (const SetOfStates& F) {
+        if (not found)
+          return std::nullopt;
+        searched++;
+        if (actioner.getK () != K or not F.contains (*witness))
+          return std::nullopt;
+        used++;
+        verb_do (2, vout << "Speculated critical input: [" << found->get ().first << "] "
+                 /*   */ << "for " << *witness << std::endl);
+        return std::exchange (found, std::nullopt);
+      }
+
+      ~speculator () {
+        verb_do (1, vout << "Speculated inputs used: " << used << "/" << searched << std::endl);
+      }
+
+    private:
+      using State = typename SetOfStates::value_type;
+
+      FwdActions& fwd_actions;
+      Actioner& actioner;
+      typename Actioner::buffers buf;
+      std::thread worker;
+      std::atomic<bool> stopped = false;
+      int K = 0;
+      std::optional<input_and_actions_ref> found;
+      std::optional<State> witness;
+      size_t searched = 0, used = 0;
+
+      // The input that was just used is skipped, as its cpre was just
+      // computed.
+      void search (const SetOfStates& F, const typename FwdActions::value_type& current) {
+        for (const auto& f : F)
+          for (auto& el : fwd_actions) {
+            if (stopped)
+              return;
+            if (&el == &current)
+              continue;
+            const auto& [input, actions] = el;
+            if (std::none_of (actions.begin (), actions.end (), [&] (const auto& action) {
+                  return F.contains (actioner.apply_forward (f, action, buf));
+                })) {
+              found = std::ref (el);
+              witness = f.copy ();
+              return;
+            }
+          }
+      }
+  };
+}
@@ -6,3 +6,4 @@
 #include "ios_precomputers/standard.hh"
 #include "ios_precomputers/fake_vars.hh"
 #include "ios_precomputers/delegate.hh"
+#include "ios_precomputers/cached.hh"
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <list>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <spot/twa/formula2bdd.hh>
+#include <spot/twaalgos/hoa.hh>
+
+namespace ios_precomputers {
+  // Directory where cached<Inner> keeps its results, set with --ios-cache.
+  // If empty, nothing is read nor written.
+  inline std::string cache_directory;
+
+  namespace detail {
+    // Runs the Inner precomputer, or loads its result from the cache
+    // directory.  The files are named after a hash of the automaton (in HOA),
+    // of the supports, of the BDD variables of the atomic propositions, and
+    // of Inner::name, a name that does not change across compilers.  They
+    // contain the inputs, saved with bdd_save, each followed by the
+    // transitions of its IOs.
+    template <typename Aut, typename Inner>
+    class cached {
+      public:
+        using transset = std::vector<std::pair<unsigned, unsigned>>;
+        using inputs_to_ios_t = std::list<std::pair<bdd, std::list<transset>>>;
+
+        cached (Aut aut, bdd input_support, bdd output_support) :
+          aut {aut}, input_support {input_support}, output_support {output_support}
+        {}
+
+        inputs_to_ios_t operator() () const {
+          if (cache_directory.empty ())
+            return compute ();
+
+          auto path = std::filesystem::path (cache_directory) / (key () + ".ios");
+          if (auto res = load (path)) {
+            verb_do (1, vout << "IOs loaded from " << path << std::endl);
+            return std::move (*res);
+          }
+
+          auto res = compute ();
+          store (path, res);
+          verb_do (1, vout << "IOs saved to " << path << std::endl);
+          return res;
+        }
+
+      private:
+        Aut aut;
+        const bdd input_support, output_support;
+
+        inputs_to_ios_t compute () const {
+          inputs_to_ios_t res;
+          // The precomputers return closures over the arguments of make, so
+          // they are made and called in a single expression.
+          for (const auto& [input, ios] : Inner::make (aut, input_support, output_support) ()) {
+            auto& [_, res_ios] = res.emplace_back (input, std::list<transset> ());
+            for (const auto& io : ios)
+              res_ios.emplace_back (io.begin (), io.end ());
+          }
+          return res;
+        }
+
+        std::string key () const {
+          std::ostringstream os;
+          os << "acacia-bonsai IOs 2\n" << Inner::name << "\n";
+          spot::print_hoa (os, aut);
+          auto dict = aut->get_dict ();
+          os << "\n" << spot::bdd_to_formula (input_support, dict)
+             << "\n" << spot::bdd_to_formula (output_support, dict) << "\n";
+          for (const auto& ap : aut->ap ())
+            os << ap << " " << dict->varnum (ap) << "\n";
+
+          // FNV-1a, as the hash must not change across runs.
+          uint64_t h = 0xcbf29ce484222325ul;
+          for (unsigned char c : os.str ()) {
+            h ^= c;
+            h *= 0x100000001b3ul;
+          }
+          char hex[17];
+          std::snprintf (hex, sizeof (hex), "%016lx", (unsigned long) h);
+          return hex;
+        }
+
+        static std::optional<inputs_to_ios_t> load (const std::filesystem::path& path) {
+          int fd = open (path.c_str (), O_RDONLY);
+          if (fd == -1)
+            return std::nullopt;
+          struct stat st;
+          void* map = MAP_FAILED;
+          if (fstat (fd, &st) == 0 and st.st_size > 0)
+            map = mmap (nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+          close (fd);
+          if (map == MAP_FAILED)
+            return std::nullopt;
+
+          std::optional<inputs_to_ios_t> res;
+          if (FILE* in = fmemopen (map, st.st_size, "r")) {
+            res = read (in);
+            std::fclose (in);
+          }
+          munmap (map, st.st_size);
+          return res;
+        }
+
+        static std::optional<inputs_to_ios_t> read (FILE* in) {
+          inputs_to_ios_t res;
+          size_t ninputs;
+          bool ok = (std::fscanf (in, "%zu", &ninputs) == 1);
+          for (size_t i = 0; ok and i < ninputs; ++i) {
+            bdd input;
+            size_t nios = 0;
+            ok = (bdd_load (in, input) == 0) and (std::fscanf (in, "%zu", &nios) == 1);
+            auto& [_, ios] = res.emplace_back (input, std::list<transset> ());
+            for (size_t io = 0; ok and io < nios; ++io) {
+              size_t ntrans;
+              ok = (std::fscanf (in, "%zu", &ntrans) == 1);
+              auto& trans = ios.emplace_back (ok ? ntrans : 0);
+              for (auto& [p, q] : trans)
+                ok = ok and (std::fscanf (in, "%u %u", &p, &q) == 2);
+            }
+          }
+          if (not ok)
+            return std::nullopt;
+          return res;
+        }
+
+        // Writes to a temporary file first, so that concurrent runs never
+        // read a partial file.
+        static void store (const std::filesystem::path& path, const inputs_to_ios_t& res) {
+          std::error_code ec;
+          std::filesystem::create_directories (path.parent_path (), ec);
+          auto tmp = path;
+          tmp += "." + std::to_string (getpid ()) + ".tmp";
+          FILE* out = std::fopen (tmp.c_str (), "w");
+          if (not out)
+            return;
+
+          std::fprintf (out, "%zu\n", res.size ());
+          for (const auto& [input, ios] : res) {
+            bdd_save (out, input);
+            std::fprintf (out, "%zu\n", ios.size ());
+            for (const auto& trans : ios) {
+              std::fprintf (out, "%zu", trans.size ());
+              for (const auto& [p, q] : trans)
+                std::fprintf (out, " %u %u", p, q);
+              std::fprintf (out, "\n");
+            }
+          }
+
+          if (std::fclose (out) == 0)
+            std::filesystem::rename (tmp, path, ec);
+          else
+            std::filesystem::remove (tmp, ec);
+        }
+    };
+  }
+
+  template <typename Inner>
+  struct cached {
+      template <typename Aut>
+      static auto make (Aut aut, bdd input_support, bdd output_support) {
+        return detail::cached<Aut, Inner> (aut, input_support, output_support);
+      }
+  };
+}
@@ -112,6 +112,8 @@ namespace ios_precomputers {
   }
 
   struct fake_vars {
+      static constexpr auto name = "fake_vars";
+
       template <typename Aut, typename TransSet = std::vector<std::pair<unsigned, unsigned>>>
       static auto make (Aut aut, bdd input_support, bdd output_support) {
         return detail::fake_vars<Aut, TransSet> (aut, input_support, output_support);
@@ -1,5 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdio>
+#include <list>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include "utils/transition_enumerator.hh"
 
 namespace ios_precomputers {
@@ -65,10 +75,19 @@ namespace ios_precomputers {
 
      3. Compute C' & S and project it on the X_? variables.
      4. Iterate through each of the variables that appear: if X_S' appears, this means that S cap S' is nonempty.
+
+     *Parallel version.*
+
+     The unambiguous refinement of C1 u C2 is made of the nonempty pairwise
+     intersections of refinements of C1 and C2.  With POWSET_WORKERS
+     workers, power splits C into chunks refined by power_sequential in
+     child processes, which inherit the BDD manager and send back their
+     partitions with bdd_save, each block with the indices of its sets.  The
+     parent then merges the partitions by pairwise intersection.
      */
     template <typename RetSet, typename FormSet, typename Projection>
-    auto power (const FormSet& formulas_to_transs,
-                const Projection& projection) {
+    auto power_sequential (const FormSet& formulas_to_transs,
+                           const Projection& projection) {
       RetSet powset;
 
       powset.push_back (typename RetSet::value_type (bddtrue, {}));
@@ -99,6 +118,141 @@ namespace ios_precomputers {
       return powset;
     }
 
+    // A partition where each block lists the indices of the sets it is in.
+    using index_partition = std::list<std::pair<bdd, std::vector<unsigned>>>;
+
+    // Refines the formulas of [begin, end) in a child process, which writes
+    // its partition to a pipe.  Returns the pid of the child and the read end
+    // of the pipe, or a pid of -1 if the child could not be started.
+    //
+    // The child is a fork of the whole process, BDD manager included, and
+    // only the calling thread survives in it: this must run before the
+    // solver starts any thread (PIPELINE, PICKER_WORKERS), which is the case
+    // as the IOs are precomputed before the actioner and the picker are made.
+    static std::pair<pid_t, int> power_fork (const std::vector<bdd>& forms,
+                                             size_t begin, size_t end) {
+      int fds[2];
+      if (pipe (fds) != 0)
+        return {-1, -1};
+      pid_t pid = fork ();
+      if (pid == -1) {
+        close (fds[0]);
+        close (fds[1]);
+        return {-1, -1};
+      }
+      if (pid != 0) {
+        close (fds[1]);
+        return {pid, fds[0]};
+      }
+
+      close (fds[0]);
+      std::vector<std::pair<bdd, unsigned>> chunk;
+      for (size_t i = begin; i < end; ++i)
+        chunk.emplace_back (forms[i], i);
+      auto part = power_sequential<index_partition> (chunk, [] (bdd b) { return b; });
+
+      FILE* out = fdopen (fds[1], "w");
+      std::fprintf (out, "%zu\n", part.size ());
+      for (const auto& [block, indices] : part) {
+        bdd_save (out, block);
+        std::fprintf (out, "%zu", indices.size ());
+        for (auto i : indices)
+          std::fprintf (out, " %u", i);
+        std::fprintf (out, "\n");
+      }
+      std::fclose (out);
+      _exit (0);
+    }
+
+    // Reads the partition written by power_fork, or nothing on error.
+    static std::optional<index_partition> power_read (int fd) {
+      FILE* in = fdopen (fd, "r");
+      index_partition part;
+      size_t nblocks;
+      bool ok = (std::fscanf (in, "%zu", &nblocks) == 1);
+      for (size_t b = 0; ok and b < nblocks; ++b) {
+        bdd block;
+        size_t nindices = 0;
+        ok = (bdd_load (in, block) == 0) and (std::fscanf (in, "%zu", &nindices) == 1);
+        if (not ok)
+          break;
+        auto& [_, indices] = part.emplace_back (block, std::vector<unsigned> (nindices));
+        for (size_t i = 0; ok and i < nindices; ++i)
+          ok = (std::fscanf (in, "%u", &indices[i]) == 1);
+      }
+      std::fclose (in);
+      if (not ok)
+        return std::nullopt;
+      return part;
+    }
+
+    static index_partition power_merge (const index_partition& lhs, const index_partition& rhs) {
+      index_partition res;
+      for (const auto& [lblock, lindices] : lhs)
+        for (const auto& [rblock, rindices] : rhs) {
+          bdd block = lblock & rblock;
+          if (block != bddfalse) {
+            auto& [_, indices] = res.emplace_back (block, lindices);
+            indices.insert (indices.end (), rindices.begin (), rindices.end ());
+          }
+        }
+      return res;
+    }
+
+    template <typename RetSet, typename FormSet, typename Projection>
+    auto power (const FormSet& formulas_to_transs,
+                const Projection& projection) {
+      constexpr size_t min_chunk = 64;
+      // hardware_concurrency () is 0 if unknown.
+      size_t workers = POWSET_WORKERS ? POWSET_WORKERS : std::max (1u, std::thread::hardware_concurrency ());
+
+      using item_t = std::decay_t<decltype ((*std::begin (formulas_to_transs)).second)>;
+      std::vector<bdd> forms;
+      std::vector<item_t> items;
+      if (workers > 1)
+        for (const auto& [formula, transs] : formulas_to_transs) {
+          forms.push_back (projection (formula));
+          items.push_back (transs);
+        }
+      workers = std::min (workers, forms.size () / min_chunk);
+      if (workers <= 1)
+        return power_sequential<RetSet> (formulas_to_transs, projection);
+
+      verb_do (1, vout << "Powerset refinement of " << forms.size ()
+               /*   */ << " sets with " << workers << " workers" << std::endl);
+
+      std::vector<std::pair<size_t, size_t>> chunks;
+      std::vector<std::pair<pid_t, int>> children;
+      for (size_t w = 0; w < workers; ++w) {
+        chunks.emplace_back (w * forms.size () / workers, (w + 1) * forms.size () / workers);
+        children.push_back (power_fork (forms, chunks[w].first, chunks[w].second));
+      }
+
+      std::optional<index_partition> merged;
+      for (size_t w = 0; w < workers; ++w) {
+        std::optional<index_partition> part;
+        if (children[w].first != -1) {
+          part = power_read (children[w].second);
+          waitpid (children[w].first, nullptr, 0);
+        }
+        if (not part) { // The child failed, refine this chunk here.
+          std::vector<std::pair<bdd, unsigned>> chunk;
+          for (size_t i = chunks[w].first; i < chunks[w].second; ++i)
+            chunk.emplace_back (forms[i], i);
+          part = power_sequential<index_partition> (chunk, [] (bdd b) { return b; });
+        }
+        merged = merged ? power_merge (*merged, *part) : std::move (*part);
+      }
+
+      RetSet powset;
+      for (const auto& [block, indices] : *merged) {
+        auto& [_, transs] = powset.emplace_back (block, typename RetSet::value_type::second_type {});
+        for (auto i : indices)
+          transs.push_back (items[i]);
+      }
+      return powset;
+    }
+
     template <typename Aut, typename TransSet>
     class powset {
       public:
@@ -129,6 +283,8 @@ namespace ios_precomputers {
   }
 
   struct powset {
+      static constexpr auto name = "powset";
+
       template <typename Aut, typename TransSet = std::vector<std::pair<unsigned, unsigned>>>
       static auto make (Aut aut, bdd input_support, bdd output_support) {
         return detail::powset<Aut, TransSet> (aut, input_support, output_support);
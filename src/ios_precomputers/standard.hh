@@ -138,6 +138,8 @@ namespace ios_precomputers {
   }
 
   struct standard {
+      static constexpr auto name = "standard";
+
       template <typename Aut, typename TransSet = std::vector<std::pair<int, int>>>
       static auto make (Aut aut,
                         bdd input_support, bdd output_support) {
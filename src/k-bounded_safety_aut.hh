@@ -5,10 +5,13 @@
 
 #include <algorithm>
 #include <map>
+#include <set>
 #include <functional>
 #include <random>
 #include <list>
 #include <chrono>
+#include <optional>
+#include <type_traits>
 
 #include <spot/twa/formula2bdd.hh>
 #include <spot/twa/twagraph.hh>
@@ -20,10 +23,12 @@
 #include <utils/verbose.hh>
 
 #include "vectors.hh"
+#include "downsets.hh"
 
 #include "ios_precomputers.hh"
 #include "input_pickers.hh"
 #include "actioners.hh"
+#include "symmetries.hh"
 
 //#define debug(A...) do { std::cout << A << std::endl; } while (0)
 #define debug(A...)
@@ -67,9 +72,23 @@ class k_bounded_safety_aut_detail {
       verb_do (1, vout << "Make actions..." << std::endl);
       auto actioner = actioner_maker.make (aut, inputs_to_ios, K);
       verb_do (1, vout << "Fetching IO actions" << std::endl);
-      auto input_output_fwd_actions = actioner.actions ();
+      auto& input_output_fwd_actions = actioner.actions ();
       verb_do (1, io_stats (input_output_fwd_actions));
 
+      // F is kept closed under the symmetries, so that the picker only needs
+      // the representatives of the orbits of inputs.  The orbits are computed
+      // on the inputs compiled upfront, of which there are none with
+      // LAZY_ACTIONS.
+      static_assert (not (SYMMETRY and LAZY_ACTIONS),
+                     "SYMMETRY needs all the inputs upfront, and cannot be used with LAZY_ACTIONS.");
+      std::vector<symmetries::symmetry> syms;
+      if constexpr (SYMMETRY)
+        syms = symmetries::detect (aut, input_support, output_support);
+      auto orbit_representatives = syms.empty () ?
+        std::remove_reference_t<decltype (input_output_fwd_actions)> () :
+        symmetries::representatives (input_output_fwd_actions, syms);
+      auto& picked_fwd_actions = syms.empty () ? input_output_fwd_actions : orbit_representatives;
+
       auto safe_vector = utils::vector_mm<char> (aut->num_states (), K - 1);
 
       for (size_t i = vectors::bool_threshold; i < aut->num_states (); ++i)
@@ -82,13 +101,33 @@ class k_bounded_safety_aut_detail {
       init.assign (aut->num_states (), -1);
       init[aut->get_init_state_number ()] = 0;
 
-      auto input_picker = input_picker_maker.make (input_output_fwd_actions, actioner);
+      auto input_picker = input_picker_maker.make (picked_fwd_actions, actioner);
+
+      // With PIPELINE, the next critical input is looked for during the cpre.
+      using Actioner = decltype (actioner);
+      constexpr bool pipelined = PIPELINE and actioners::has_apply_forward<Actioner>::value;
+      using speculator_t = input_pickers::speculator<std::remove_reference_t<decltype (picked_fwd_actions)>,
+                                                     Actioner, SetOfStates>;
+      std::optional<std::conditional_t<pipelined, speculator_t, int>> speculator;
+      if constexpr (pipelined)
+        speculator.emplace (picked_fwd_actions, actioner);
 
       do {
         loopcount++;
         verb_do (1, vout << "Loop# " << loopcount << ", F of size " << F.size () << std::endl);
-
-        auto&& input = input_picker (F);
+        if constexpr (APPLY_CACHE_SIZE > 0 and actioners::has_cache_stats<Actioner>::value)
+          verb_do (1, vout << "Apply cache: " << actioner.cache_stats ().first << " hits, "
+                   /*   */ << actioner.cache_stats ().second << " misses" << std::endl);
+
+        auto&& input = [&] () -> decltype (input_picker (F)) {
+          if constexpr (pipelined)
+            if (auto next = speculator->next (F)) {
+              if constexpr (input_pickers::has_used<decltype (input_picker)>::value)
+                input_picker.used (*next, F.size ());
+              return next;
+            }
+          return input_picker (F);
+        } ();
         if (not input.has_value ()) {
           std::cout<< "ANTICHAIN" << std::endl;// No more inputs, and we just tested that init was present
           F.apply ([&] (const State& s) {
@@ -100,7 +139,16 @@ class k_bounded_safety_aut_detail {
           std::cout<< "ANTICHAINEND" << std::endl;
           return true;}
 
-        cpre_inplace (F, *input, actioner);
+        if constexpr (pipelined) {
+          speculator->start (F, input->get ());
+          auto F1 = cpre_union (F, *input, actioner);
+          speculator->stop ();
+          F.intersect_with (std::move (F1));
+        }
+        else
+          cpre_inplace (F, *input, actioner);
+        if constexpr (SYMMETRY)
+          symmetries::symmetrize (F, syms);
         if (not F.contains (State (init))) {
           if (K >= Kto)
             return false;
@@ -145,6 +193,13 @@ class k_bounded_safety_aut_detail {
     // F1i = \cup_{o \in O} PreHat (F, i, o)
     template <typename Action, typename Actioner>
     void cpre_inplace (SetOfStates& F, const Action& io_action, Actioner& actioner) {
+      F.intersect_with (cpre_union (F, io_action, actioner));
+      verb_do (2, vout << "F = " << std::endl << F);
+    }
+
+    // Computes F1i, only reading F.
+    template <typename Action, typename Actioner>
+    SetOfStates cpre_union (const SetOfStates& F, const Action& io_action, Actioner& actioner) {
 
       verb_do (2, vout << "Computing cpre(F) with F = " << std::endl << F);
 
@@ -153,14 +208,27 @@ class k_bounded_safety_aut_detail {
       auto vv = typename SetOfStates::value_type (v);
       SetOfStates F1i (std::move (vv));
       bool first_turn = true;
+      std::set<unsigned> done_ids;
       for (const auto& action_vec : actions) {
+        // Equal actions have equal images, and the union is idempotent.
+        if constexpr (actioners::has_action_ids<Actioner>::value)
+          if (not done_ids.insert (action_vec.id).second)
+            continue;
         verb_do (3, vout << "one_output_letter:" << std::endl);
 
-        SetOfStates&& F1io = F.apply ([this, &action_vec, &actioner] (const auto& m) {
-          auto&& ret = actioner.apply (m, action_vec, actioners::direction::backward);
-          verb_do (3, vout << "  " << m << " -> " << ret << std::endl);
-          return std::move (ret);
-        });
+        SetOfStates&& F1io = [&] () {
+          if constexpr (downsets::has_apply_by_block<SetOfStates>::value and
+                        actioners::has_apply_block<Actioner>::value)
+            return F.apply_by_block ([&action_vec, &actioner] (std::span<const State> block) {
+              return actioner.apply_block (block, action_vec, actioners::direction::backward);
+            });
+          else
+            return F.apply ([this, &action_vec, &actioner] (const auto& m) {
+              auto&& ret = actioner.apply (m, action_vec, actioners::direction::backward);
+              verb_do (3, vout << "  " << m << " -> " << ret << std::endl);
+              return std::move (ret);
+            });
+        } ();
 
         if (first_turn) {
           F1i = std::move (F1io);
@@ -170,8 +238,7 @@ class k_bounded_safety_aut_detail {
           F1i.union_with (std::move (F1io));
       }
 
-      F.intersect_with (std::move (F1i));
-      verb_do (2, vout << "F = " << std::endl << F);
+      return F1i;
     }
 
     template <typename IToActions>
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include <spot/twa/twagraph.hh>
+
+#include "utils/vector_mm.hh"
+#include "vectors.hh"
+
+// Symmetries of the automaton, as in parametric specifications where the
+// clients of an arbiter are interchangeable.  A symmetry is a permutation of
+// the atomic propositions, mapping inputs to inputs and outputs to outputs,
+// together with a permutation of the states, such that p -c-> q is a
+// transition iff perm(p) -σ(c)-> perm(q) is one, and that preserves the
+// initial state, the accepting states, and the Boolean states.
+//
+// If F is closed under the permutation of states, the cpre for the input σ(i)
+// is the permutation of the cpre for i.  So the solver only needs to pick
+// among the representatives of the orbits of the inputs, provided that F is
+// kept closed under the permutations (see symmetrize).
+namespace symmetries {
+  struct symmetry {
+      std::shared_ptr<bddPair> aps; // Swaps the BDD variables.
+      std::vector<unsigned> states;
+  };
+
+  namespace detail {
+    static std::vector<int> support_vars (bdd support) {
+      std::vector<int> vars;
+      for (; support != bddtrue; support = bdd_high (support))
+        vars.push_back (bdd_var (support));
+      return vars;
+    }
+
+    // Looks for a permutation of the states that, with the given permutation
+    // of the variables, leaves the automaton unchanged.  The permutation is
+    // built by matching the transitions from the initial state, which is
+    // fixed.  When several successors are possible, the first one is taken,
+    // so some symmetries may be missed, but the result is always checked.
+    template <typename Aut>
+    std::optional<std::vector<unsigned>> states_permutation (const Aut& aut, bddPair* aps) {
+      const unsigned n = aut->num_states (), none = n;
+      std::vector<unsigned> perm (n, none), inv (n, none);
+      auto map = [&] (unsigned p, unsigned q) {
+        if (perm[p] != none or inv[q] != none)
+          return perm[p] == q;
+        perm[p] = q;
+        inv[q] = p;
+        return true;
+      };
+
+      // The transitions from p, by the id of their (permuted) label.
+      auto out = [&] (unsigned p, bool permute) {
+        std::map<int, std::vector<unsigned>> ret;
+        for (const auto& e : aut->out (p))
+          ret[(permute ? bdd_replace (e.cond, aps) : e.cond).id ()].push_back (e.dst);
+        return ret;
+      };
+
+      std::deque<unsigned> todo;
+      map (aut->get_init_state_number (), aut->get_init_state_number ());
+      todo.push_back (aut->get_init_state_number ());
+      while (not todo.empty ()) {
+        unsigned p = todo.front ();
+        todo.pop_front ();
+        auto from = out (p, true), to = out (perm[p], false);
+        if (from.size () != to.size ())
+          return std::nullopt;
+        for (auto& [cond, dsts] : from) {
+          auto it = to.find (cond);
+          if (it == to.end () or it->second.size () != dsts.size ())
+            return std::nullopt;
+          auto& candidates = it->second;
+          // Successors already mapped first, then the others in order.
+          for (unsigned pass = 0; pass < 2; ++pass)
+            for (auto q : dsts) {
+              if ((perm[q] == none) == (pass == 0))
+                continue;
+              auto c = (perm[q] != none) ?
+                std::find (candidates.begin (), candidates.end (), perm[q]) :
+                std::find_if (candidates.begin (), candidates.end (),
+                              [&] (unsigned c) { return inv[c] == none; });
+              if (c == candidates.end ())
+                return std::nullopt;
+              if (perm[q] == none)
+                todo.push_back (q);
+              map (q, *c);
+              candidates.erase (c);
+            }
+        }
+      }
+
+      // Unreachable states are left in place.
+      for (unsigned p = 0; p < n; ++p)
+        if (perm[p] == none and not map (p, p))
+          return std::nullopt;
+
+      for (unsigned p = 0; p < n; ++p) {
+        if (aut->state_is_accepting (p) != aut->state_is_accepting (perm[p]) or
+            (p < vectors::bool_threshold) != (perm[p] < vectors::bool_threshold))
+          return std::nullopt;
+        std::multiset<std::pair<int, unsigned>> from, to;
+        for (const auto& e : aut->out (p))
+          from.emplace (bdd_replace (e.cond, aps).id (), perm[e.dst]);
+        for (const auto& e : aut->out (perm[p]))
+          to.emplace (e.cond.id (), e.dst);
+        if (from != to)
+          return std::nullopt;
+      }
+      return perm;
+    }
+  }
+
+  // Finds symmetries swapping two inputs, and possibly two outputs.  A swap
+  // is only tried if the two inputs are not already in the same orbit, so
+  // that at most one symmetry per input is kept.
+  template <typename Aut>
+  std::vector<symmetry> detect (const Aut& aut, bdd input_support, bdd output_support) {
+    std::vector<symmetry> ret;
+    auto ins = detail::support_vars (input_support), outs = detail::support_vars (output_support);
+
+    // Labels of the automaton, by id: a symmetry maps each of them to one of them.
+    std::map<int, bdd> conds;
+    for (unsigned p = 0; p < aut->num_states (); ++p)
+      for (const auto& e : aut->out (p))
+        conds.emplace (e.cond.id (), e.cond);
+
+    // No swap of outputs, then each of them.
+    std::vector<std::pair<int, int>> out_swaps = {{-1, -1}};
+    for (size_t c = 0; c < outs.size (); ++c)
+      for (size_t d = c + 1; d < outs.size (); ++d)
+        out_swaps.emplace_back (outs[c], outs[d]);
+
+    std::vector<size_t> orbit (ins.size ());
+    std::iota (orbit.begin (), orbit.end (), 0);
+    auto find = [&] (size_t i) {
+      while (orbit[i] != i)
+        i = orbit[i];
+      return i;
+    };
+
+    for (size_t a = 0; a < ins.size (); ++a)
+      for (size_t b = a + 1; b < ins.size (); ++b)
+        for (auto [c, d] : out_swaps) {
+          if (find (a) == find (b))
+            break;
+          std::shared_ptr<bddPair> aps (bdd_newpair (), bdd_freepair);
+          bdd_setpair (aps.get (), ins[a], ins[b]);
+          bdd_setpair (aps.get (), ins[b], ins[a]);
+          if (c != -1) {
+            bdd_setpair (aps.get (), c, d);
+            bdd_setpair (aps.get (), d, c);
+          }
+
+          if (not std::all_of (conds.begin (), conds.end (), [&] (const auto& cond) {
+                return conds.contains (bdd_replace (cond.second, aps.get ()).id ());
+              }))
+            continue;
+          if (auto perm = detail::states_permutation (aut, aps.get ())) {
+            ret.push_back ({aps, std::move (*perm)});
+            orbit[find (b)] = find (a);
+          }
+        }
+
+    verb_do (1, vout << "Symmetries found: " << ret.size () << std::endl);
+    return ret;
+  }
+
+  // Keeps one input of each orbit of the inputs of actions under the
+  // symmetries, that is, the inputs that are not the image of a previous
+  // input.  Inputs whose images are not inputs of actions are kept.
+  template <typename Actions>
+  Actions representatives (const Actions& actions, const std::vector<symmetry>& syms) {
+    std::map<int, size_t> index; // Position of the inputs, by BDD id.
+    size_t i = 0;
+    for (const auto& [input, _] : actions)
+      index.emplace (input.id (), i++);
+
+    std::vector<size_t> orbit (i);
+    std::iota (orbit.begin (), orbit.end (), 0);
+    auto find = [&] (size_t i) {
+      while (orbit[i] != i)
+        i = orbit[i];
+      return i;
+    };
+
+    i = 0;
+    for (const auto& [input, _] : actions) {
+      for (const auto& sym : syms) {
+        auto it = index.find (bdd_replace (input, sym.aps.get ()).id ());
+        if (it != index.end ()) {
+          size_t x = find (i), y = find (it->second);
+          orbit[std::max (x, y)] = std::min (x, y);
+        }
+      }
+      ++i;
+    }
+
+    Actions ret;
+    i = 0;
+    for (const auto& el : actions) {
+      if (find (i) == i)
+        ret.push_back (el);
+      ++i;
+    }
+    verb_do (1, vout << "Input orbits: " << ret.size () << "/" << actions.size () << std::endl);
+    return ret;
+  }
+
+  // Restricts F to its largest subset closed under the permutations of
+  // states: F is intersected with its images until none removes anything.
+  template <typename SetOfStates>
+  void symmetrize (SetOfStates& F, const std::vector<symmetry>& syms) {
+    using State = typename SetOfStates::value_type;
+    for (bool changed = true; changed; ) {
+      changed = false;
+      for (const auto& sym : syms) {
+        auto image = F.apply ([&sym] (const State& s) {
+          auto vec = utils::vector_mm<char> (sym.states.size ());
+          for (size_t i = 0; i < sym.states.size (); ++i)
+            vec[sym.states[i]] = s[i];
+          return State (vec);
+        });
+        // The iterators of some downsets do not support std::all_of.
+        bool closed = true;
+        for (const auto& s : F)
+          if (not image.contains (s)) {
+            closed = false;
+            break;
+          }
+        if (not closed) {
+          F.intersect_with (std::move (image));
+          changed = true;
+        }
+      }
+    }
+  }
+}
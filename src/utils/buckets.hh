@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+// Runtime sizes are rounded up to a small set of buckets before being turned
+// into template parameters, so that only a few copies of the solver are
+// instantiated.
+
+namespace utils {
+  namespace buckets {
+#if CAPACITY_BUCKETS
+    // Capacities, in allocation granules: 1, 2, 3, 4, 6, 8, 12, 16, 24, ...
+    static constexpr size_t capacity (size_t i) {
+      if (i == 0)
+        return 1;
+      return (i % 2) ? (size_t {1} << ((i + 1) / 2)) : (size_t {3} << (i / 2 - 1));
+    }
+
+    // Bitset counts: 0, 1, 2, 4, 8, ...
+    static constexpr size_t bitsets (size_t i) {
+      return (i == 0) ? 0 : (size_t {1} << (i - 1));
+    }
+#else
+    static constexpr size_t capacity (size_t i) { return i + 1; }
+    static constexpr size_t bitsets (size_t i) { return i; }
+#endif
+
+    // Smallest bucket index whose capacity is at least n granules.
+    static constexpr size_t capacity_index (size_t n) {
+      size_t i = 0;
+      while (capacity (i) < n)
+        ++i;
+      return i;
+    }
+
+    // Smallest bucket index with at least n bitsets.
+    static constexpr size_t bitsets_index (size_t n) {
+      size_t i = 0;
+      while (bitsets (i) < n)
+        ++i;
+      return i;
+    }
+  }
+}
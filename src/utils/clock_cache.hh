@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace utils {
+  // A map holding at most capacity entries.  When full, an insertion evicts
+  // an entry using the clock (second chance) policy: the hand sweeps the
+  // slots, evicting the first one that was not looked up since the last
+  // sweep.
+  template <typename Key, typename Value, typename Hash = std::hash<Key>>
+  class clock_cache {
+    public:
+      clock_cache (size_t capacity) : capacity {capacity} {
+        slots.reserve (capacity);
+        index.reserve (capacity);
+      }
+
+      // Returns the cached value for key, or nullptr.
+      const Value* find (const Key& key) {
+        auto it = index.find (key);
+        if (it == index.end ()) {
+          misses++;
+          return nullptr;
+        }
+        hits++;
+        auto& slot = slots[it->second];
+        slot.referenced = true;
+        return &*slot.value;
+      }
+
+      void insert (Key key, Value&& value) {
+        if (capacity == 0 or index.contains (key))
+          return;
+
+        size_t pos;
+        if (slots.size () < capacity) {
+          pos = slots.size ();
+          slots.emplace_back ();
+        }
+        else {
+          while (slots[hand].referenced) {
+            slots[hand].referenced = false;
+            hand = (hand + 1) % capacity;
+          }
+          pos = hand;
+          hand = (hand + 1) % capacity;
+          index.erase (slots[pos].key);
+        }
+
+        slots[pos].key = key;
+        slots[pos].value.emplace (std::move (value));
+        slots[pos].referenced = false;
+        index.emplace (std::move (key), pos);
+      }
+
+      void clear () {
+        slots.clear ();
+        index.clear ();
+        hand = 0;
+      }
+
+      size_t size () const { return slots.size (); }
+
+      size_t hits = 0, misses = 0;
+
+    private:
+      struct slot {
+          Key key;
+          // Values need not be default constructible nor copyable.
+          std::optional<Value> value;
+          bool referenced;
+      };
+
+      const size_t capacity;
+      std::vector<slot> slots;
+      std::unordered_map<Key, size_t, Hash> index;
+      size_t hand = 0;
+  };
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+namespace utils {
+  // A bitset whose size is only known at runtime.  It implements the subset
+  // of std::bitset's interface used by vectors::X_and_bitset, with word-wide
+  // operations.  Bits past size () are always kept at 0, so that words can be
+  // compared directly.
+  //
+  // All the bitsets of a run have the same size, so it is not stored in each
+  // of them: it is read from NBits, which is set once before any bitset is
+  // built.  A bitset is then a single pointer to its words.
+  template <const size_t& NBits>
+  class dynamic_bitset {
+      using self = dynamic_bitset<NBits>;
+    public:
+      using word = unsigned long;
+      static constexpr size_t bits_per_word = sizeof (word) * 8;
+
+      static constexpr size_t nwords (size_t nbits) {
+        return (nbits + bits_per_word - 1) / bits_per_word;
+      }
+
+      dynamic_bitset () : words {std::make_unique<word[]> (num_words ())} { }
+
+      dynamic_bitset (const self& other) : words {std::make_unique_for_overwrite<word[]> (num_words ())} {
+        std::copy_n (other.words.get (), num_words (), words.get ());
+      }
+
+      dynamic_bitset (self&& other) = default;
+
+      self& operator= (const self& other) {
+        if (not words)
+          words = std::make_unique_for_overwrite<word[]> (num_words ());
+        std::copy_n (other.words.get (), num_words (), words.get ());
+        return *this;
+      }
+
+      self& operator= (self&& other) = default;
+
+      static size_t size () { return NBits; }
+
+      void reset () {
+        std::fill_n (words.get (), num_words (), 0);
+      }
+
+      bool test (size_t i) const {
+        assert (i < size ());
+        return (words[i / bits_per_word] >> (i % bits_per_word)) & 1;
+      }
+
+      bool operator[] (size_t i) const {
+        return test (i);
+      }
+
+      self& set (size_t i, bool val = true) {
+        assert (i < size ());
+        word bit = word {1} << (i % bits_per_word);
+        if (val)
+          words[i / bits_per_word] |= bit;
+        else
+          words[i / bits_per_word] &= ~bit;
+        return *this;
+      }
+
+      size_t count () const {
+        size_t res = 0;
+        for (size_t i = 0; i < num_words (); ++i)
+          res += std::popcount (words[i]);
+        return res;
+      }
+
+      self& operator&= (const self& rhs) {
+        for (size_t i = 0; i < num_words (); ++i)
+          words[i] &= rhs.words[i];
+        return *this;
+      }
+
+      self& operator|= (const self& rhs) {
+        for (size_t i = 0; i < num_words (); ++i)
+          words[i] |= rhs.words[i];
+        return *this;
+      }
+
+      self operator& (const self& rhs) const {
+        auto res = *this;
+        return res &= rhs;
+      }
+
+      self operator| (const self& rhs) const {
+        auto res = *this;
+        return res |= rhs;
+      }
+
+      // True if every bit set in *this is set in rhs; avoids materializing
+      // the union when checking domination.
+      bool is_subset_of (const self& rhs) const {
+        for (size_t i = 0; i < num_words (); ++i)
+          if (words[i] & ~rhs.words[i])
+            return false;
+        return true;
+      }
+
+      bool operator== (const self& rhs) const {
+        return std::equal (words.get (), words.get () + num_words (), rhs.words.get ());
+      }
+
+      bool operator!= (const self& rhs) const {
+        return not (*this == rhs);
+      }
+
+      // Total order, used by Sets.
+      bool operator< (const self& rhs) const {
+        return std::lexicographical_compare (words.get (), words.get () + num_words (),
+                                             rhs.words.get (), rhs.words.get () + num_words ());
+      }
+
+      const word* data () const { return words.get (); }
+      // Callers writing through data () must keep the bits past size () at 0.
+      word* data () { return words.get (); }
+      static size_t num_words () { return nwords (NBits); }
+
+    private:
+      std::unique_ptr<word[]> words;
+  };
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace utils {
+  // The narrowest unsigned integer type that can hold Max.
+  template <uintmax_t Max>
+  using narrowest_uint =
+    std::conditional_t<Max <= UINT8_MAX, uint8_t,
+                       std::conditional_t<Max <= UINT16_MAX, uint16_t,
+                                          std::conditional_t<Max <= UINT32_MAX, uint32_t,
+                                                             uint64_t>>>;
+
+  // The narrowest signed integer type that can hold all values in [Min, Max].
+  template <intmax_t Min, intmax_t Max>
+  using narrowest_int =
+    std::conditional_t<INT8_MIN <= Min and Max <= INT8_MAX, int8_t,
+                       std::conditional_t<INT16_MIN <= Min and Max <= INT16_MAX, int16_t,
+                                          std::conditional_t<INT32_MIN <= Min and Max <= INT32_MAX, int32_t,
+                                                             int64_t>>>;
+
+  // The narrowest signed integer type that can hold the sum of N values of type T.
+  template <typename T, size_t N>
+  using narrowest_sum =
+    narrowest_int<(intmax_t) std::numeric_limits<T>::min () * (intmax_t) N,
+                  (intmax_t) std::numeric_limits<T>::max () * (intmax_t) N>;
+}
@@ -1,12 +1,20 @@
 #pragma once
 
 #include "configuration.hh"
-#include <experimental/simd>
+#ifndef NO_SIMD
+# include <experimental/simd>
+#else
+# include <cstdint>
+#endif
 
 namespace utils {
   template <typename Elt>
   struct simd_traits {
-#if SIMD_IS_MAX
+#ifdef NO_SIMD
+      // Without SIMD, vectors are aligned on the words used by the SWAR kernels.
+      static constexpr size_t simd_size =
+        (sizeof (uint64_t) + sizeof (Elt) - 1) / sizeof (Elt);
+#elif SIMD_IS_MAX
       static constexpr auto simd_size =
         std::experimental::simd_abi::max_fixed_size<Elt>;
 #else
@@ -26,6 +34,8 @@ namespace utils {
         return simd_size * sizeof (Elt);
       }
 
+#ifndef NO_SIMD
       using fssimd = std::experimental::fixed_size_simd<Elt, simd_size>;
+#endif
   };
 }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+
+// SIMD-within-a-register kernels: 64-bit words are seen as 8 packed signed
+// bytes.  These are used when compiling without <experimental/simd>.
+
+namespace utils {
+  namespace swar {
+    using word = uint64_t;
+
+    static constexpr size_t bytes_per_word = sizeof (word);
+
+    static constexpr size_t nwords (size_t nbytes) {
+      return (nbytes + bytes_per_word - 1) / bytes_per_word;
+    }
+
+    static constexpr word high = 0x8080808080808080ull;
+    static constexpr word even_bytes = 0x00FF00FF00FF00FFull;
+
+    // Top bit of each byte is set iff lhs >= rhs on that byte, seen as signed.
+    inline word geq (word lhs, word rhs) {
+      // Flipping the sign bit maps signed bytes monotonically to unsigned ones.
+      lhs ^= high;
+      rhs ^= high;
+      // Compare the 7 low bits: the subtraction never borrows across bytes.
+      word low_geq = ((lhs | high) - (rhs & ~high)) & high;
+      // Then let the top bit decide if they differ.
+      return ((lhs & ~rhs) | (~(lhs ^ rhs) & low_geq)) & high;
+    }
+
+    // Expand the top bit of each byte to the full byte.
+    inline word to_mask (word flags) {
+      return (flags >> 7) * 0xFF;
+    }
+
+    inline word min (word lhs, word rhs) {
+      word lhs_geq = to_mask (geq (lhs, rhs));
+      return (rhs & lhs_geq) | (lhs & ~lhs_geq);
+    }
+
+    inline word max (word lhs, word rhs) {
+      word lhs_geq = to_mask (geq (lhs, rhs));
+      return (lhs & lhs_geq) | (rhs & ~lhs_geq);
+    }
+
+    inline bool all_geq (word lhs, word rhs) {
+      return geq (lhs, rhs) == high;
+    }
+
+    // Sum of the 8 bytes, seen as signed.  The bytes are first summed as
+    // unsigned, then 256 is subtracted for each negative byte.
+    inline int sum (word w) {
+      word pairs = (w & even_bytes) + ((w >> 8) & even_bytes);
+      int usum = (int) ((pairs * 0x0001000100010001ull) >> 48);
+      return usum - 256 * std::popcount (w & high);
+    }
+
+    inline int sum (const word* w, size_t n) {
+      int res = 0;
+      for (size_t i = 0; i < n; ++i)
+        res += sum (w[i]);
+      return res;
+    }
+
+    // Computes res = min (lhs, rhs) and returns the sum of res.
+    inline int meet (const word* lhs, const word* rhs, word* res, size_t n) {
+      int res_sum = 0;
+      for (size_t i = 0; i < n; ++i) {
+        res[i] = min (lhs[i], rhs[i]);
+        res_sum += sum (res[i]);
+      }
+      return res_sum;
+    }
+  }
+}
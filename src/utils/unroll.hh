@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "utils/static_switch.hh"
+
+namespace utils {
+  // Calls f (index_t<0> {}), ..., f (index_t<N - 1> {}), fully unrolled.
+  template <size_t N, typename F>
+  inline void unroll (F&& f) {
+    [&] <size_t... Is> (std::index_sequence<Is...>) {
+      (f (index_t<Is> {}), ...);
+    } (std::make_index_sequence<N> {});
+  }
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <span>
+#include <type_traits>
+
 #include "configuration.hh"
 
 namespace vectors {
@@ -13,6 +16,11 @@ namespace vectors {
   // rest as bool.  This is this threshold:
   static size_t bitset_threshold = 0;
 
+  // The number of Boolean states stored in bitsets, that is, the dimension
+  // of the vectors minus bitset_threshold.  It is set once per run, with the
+  // thresholds, so that the vectors need not store their dimension.
+  static size_t nbitsetbools = 0;
+
   // Vectors implementing bin() should satisfy:
   //       if u.bin () < v.bin (), then u can't dominate v.
   // or equivalently:
@@ -23,6 +31,23 @@ namespace vectors {
   template <class T>
   struct has_bin<T, std::void_t<decltype (std::declval<T> ().bin ())>> : std::true_type {};
 
+  // Tag of the constructors that build a vector in place.
+  struct emplace_t {};
+  static constexpr emplace_t emplace {};
+
+  // Vectors constructible as T (emplace, k, fill, extra...), where
+  // fill (storage) writes the k values of the vector at storage, returns
+  // their sum, and should not touch storage past k.  This saves the copy
+  // and the sum pass of the other constructors.
+  template <typename T, typename... Extra>
+  using has_emplace = std::is_constructible<T, emplace_t, size_t, int (*) (typename T::value_type*), Extra...>;
+
+  // Vectors that can be built from a numeric part and the words of a bitset,
+  // see X_and_bitset.
+  template <typename T>
+  using has_bitset = std::is_constructible<T, std::span<const typename T::value_type>,
+                                           std::span<const unsigned long>, size_t>;
+
   template <template <typename T, auto...> typename T, typename Elt>
   struct traits {
       static constexpr auto capacity_for (size_t nelts) { return nelts; }
@@ -32,8 +57,12 @@ namespace vectors {
 #include "vectors/vector_backed.hh"
 #include "vectors/array_backed.hh"
 #include "vectors/array_backed_sum.hh"
-#include "vectors/simd_vector_backed.hh"
-#include "vectors/simd_array_backed.hh"
-#include "vectors/simd_array_backed_sum.hh"
+#ifndef NO_SIMD
+# include "vectors/simd_vector_backed.hh"
+# include "vectors/simd_array_backed.hh"
+# include "vectors/simd_array_backed_sum.hh"
+#endif
+#include "vectors/swar_vector_backed.hh"
+#include "vectors/swar_array_backed_sum.hh"
 
 #include "vectors/X_and_bitset.hh"
@@ -1,7 +1,11 @@
 #pragma once
 #include <bitset>
+#include <cassert>
+#include <span>
 
 #include <utils/vector_mm.hh>
+#include <utils/narrowest_int.hh>
+#include <utils/dynamic_bitset.hh>
 
 namespace vectors {
 
@@ -13,38 +17,83 @@ namespace vectors {
     return nbitsets * sizeof (unsigned long) * 8;
   }
 
+  // Use as NBitsets to have the number of Boolean states decided at runtime.
+  static constexpr size_t dynamic_nbitsets = -1ul;
+
   template <typename X, size_t NBitsets>
   class X_and_bitset {
       using self = X_and_bitset<X, NBitsets>;
 
-      static constexpr auto Bools = nbitsets_to_nbools (NBitsets);
+      static constexpr bool is_dynamic = (NBitsets == dynamic_nbitsets);
+      static constexpr auto Bools = is_dynamic ? 0 : nbitsets_to_nbools (NBitsets);
+      using bitset_type = std::conditional_t<is_dynamic,
+                                             utils::dynamic_bitset<nbitsetbools>,
+                                             std::bitset<Bools>>;
+      using sum_type = std::conditional_t<is_dynamic,
+                                          uint32_t,
+                                          utils::narrowest_uint<Bools>>;
+
     public:
       using value_type = typename X::value_type;
 
       template <typename Alloc>
       X_and_bitset (const std::vector<value_type, Alloc>& v) :
-        k {v.size ()},
-        x {std::span (v.data (), std::min (bitset_threshold, k))},
+        x {std::span (v.data (), std::min (bitset_threshold, v.size ()))},
         sum {0}
       {
+        // The dimension is not stored, see nbitsetbools.
+        assert (v.size () - x.size () == nbitsetbools);
         bools.reset ();
-        for (size_t i = bitset_threshold; i < k; ++i) {
-          if ((bools[i - bitset_threshold] = (v[i] + 1)) == true)
+        for (size_t i = bitset_threshold; i < v.size (); ++i) {
+          if (v[i] + 1) {
+            bools.set (i - bitset_threshold);
             sum++;
+          }
         }
       }
 
+      // Builds the vector from its numeric part and the words of its Boolean
+      // part, as computed by the actioners without unpacking the Booleans.
+      X_and_bitset (std::span<const value_type> numeric,
+                    std::span<const unsigned long> words, size_t nbools_) :
+        x {numeric}
+      {
+        set_bools (words, nbools_);
+      }
+
+      // Same, with the numeric part built in place, see has_emplace.
+      template <typename F,
+                typename = std::enable_if_t<std::is_constructible_v<X, emplace_t, size_t, const F&>>>
+      X_and_bitset (emplace_t, size_t k, const F& fill,
+                    std::span<const unsigned long> words, size_t nbools_) :
+        x {emplace, k, fill}
+      {
+        set_bools (words, nbools_);
+      }
+
       X_and_bitset (std::initializer_list<value_type> v) :
         X_and_bitset (utils::vector_mm<value_type> (v)) {}
 
-      size_t size () const { return k; }
+      size_t size () const { return x.size () + nbitsetbools; }
 
       X_and_bitset (self&& other) = default;
 
     private:
 
-      X_and_bitset (size_t k, X&& x, std::bitset<Bools>&& bools, size_t sum) :
-        k {k},
+      void set_bools (std::span<const unsigned long> words, size_t nbools_) {
+        assert (nbools_ == nbitsetbools);
+        assert (words.size () == nbools_to_nbitsets (nbools_));
+        if constexpr (is_dynamic)
+          std::copy (words.begin (), words.end (), bools.data ());
+        else {
+          bools.reset ();
+          for (size_t w = 0; w < words.size (); ++w)
+            bools |= bitset_type (words[w]) << (w * sizeof (unsigned long) * 8);
+        }
+        sum = bools.count ();
+      }
+
+      X_and_bitset (X&& x, bitset_type&& bools, sum_type sum) :
         x {std::move (x)},
         bools {std::move (bools)},
         sum {sum}
@@ -54,14 +103,14 @@ namespace vectors {
 
       // explicit copy operator
       self copy () const {
-        std::bitset<Bools> b = bools;
-        return X_and_bitset (k, x.copy (), std::move (b), sum);
+        bitset_type b = bools;
+        return X_and_bitset (x.copy (), std::move (b), sum);
       }
 
       self& operator= (self&& other) {
-        assert (other.k == k);
         x = std::move (other.x);
         bools = std::move (other.bools);
+        sum = other.sum;
         return *this;
       }
 
@@ -73,8 +122,8 @@ namespace vectors {
 
       void to_vector (std::span<value_type> v) const {
         x.to_vector (std::span (v.data (), bitset_threshold));
-        for (size_t i = bitset_threshold; i < k; ++i)
-          v[i] = bools[i - bitset_threshold] - 1;
+        for (size_t i = bitset_threshold; i < size (); ++i)
+          v[i] = bools.test (i - bitset_threshold) - 1;
       }
 
       class po_res {
@@ -84,9 +133,15 @@ namespace vectors {
             bleq = (lhs.sum <= rhs.sum);
 
             if (bgeq or bleq) {
-              auto diff = lhs.bools | rhs.bools;
-              bgeq = bgeq and (diff == lhs.bools);
-              bleq = bleq and (diff == rhs.bools);
+              if constexpr (is_dynamic) {
+                bgeq = bgeq and rhs.bools.is_subset_of (lhs.bools);
+                bleq = bleq and lhs.bools.is_subset_of (rhs.bools);
+              }
+              else {
+                auto diff = lhs.bools | rhs.bools;
+                bgeq = bgeq and (diff == lhs.bools);
+                bleq = bleq and (diff == rhs.bools);
+              }
             }
 
             if (not bgeq and not bleq)
@@ -109,7 +164,7 @@ namespace vectors {
       };
 
       inline auto partial_order (const self& rhs) const {
-        assert (rhs.k == k);
+        assert (rhs.size () == size ());
         return po_res (*this, rhs);
       }
 
@@ -123,25 +178,34 @@ namespace vectors {
 
       value_type operator[] (size_t i) const {
         if (i >= bitset_threshold)
-          return bools[i - bitset_threshold] - 1;
+          return bools.test (i - bitset_threshold) - 1;
         return x[i];
       }
 
     public:
       self meet (const self& rhs) const {
-        assert (rhs.k == k);
-        return self (k, x.meet (rhs.x), bools & rhs.bools, sum);
+        assert (rhs.size () == size ());
+        auto meet_bools = bools & rhs.bools;
+        auto meet_sum = meet_bools.count ();
+        return self (x.meet (rhs.x), std::move (meet_bools), meet_sum);
       }
 
       bool operator< (const self& rhs) const {
-        int cmp = std::memcmp (&bools, &rhs.bools, sizeof (bools));
-        if (cmp == 0)
-          return (x < rhs.x);
-        return (cmp < 0);
+        if constexpr (is_dynamic) {
+          if (bools == rhs.bools)
+            return (x < rhs.x);
+          return (bools < rhs.bools);
+        }
+        else {
+          int cmp = std::memcmp (&bools, &rhs.bools, sizeof (bools));
+          if (cmp == 0)
+            return (x < rhs.x);
+          return (cmp < 0);
+        }
       }
 
       auto bin () const {
-        auto bitset_bin = sum; // / (k - bitset_threshold);
+        size_t bitset_bin = sum; // / (size () - bitset_threshold);
 
         // Even if X doesn't have bin (), our local sum is valid, in that:
         //   if u dominates v, then in particular, it dominates it over the boolean part, so u.sum >= v.sum.
@@ -152,10 +216,9 @@ namespace vectors {
       }
 
     private:
-      const size_t k;
       X x;
-      std::bitset<Bools> bools;
-      size_t sum; // The sum of all the elements of bools, seen as 0/1 values.
+      bitset_type bools;
+      sum_type sum; // The sum of all the elements of bools, seen as 0/1 values.
   };
 
   template <class X>
@@ -3,6 +3,8 @@
 #include <cassert>
 #include <iostream>
 
+#include "utils/narrowest_int.hh"
+
 namespace vectors {
   // What's the multiple of T's we store.  This is used to speed up compilation
   // and reduce program size.
@@ -18,9 +20,11 @@ namespace vectors {
   class array_backed_sum_ : public std::array<T, Units * T_PER_UNIT> {
       using self = array_backed_sum_<T, Units>;
       using base = std::array<T, Units * T_PER_UNIT>;
+      using size_type = utils::narrowest_uint<Units * T_PER_UNIT>;
+      using sum_type = utils::narrowest_sum<T, Units * T_PER_UNIT>;
 
     public:
-      array_backed_sum_ (std::span<const T> v) : k {v.size ()} {
+      array_backed_sum_ (std::span<const T> v) : k {(size_type) v.size ()} {
         sum = 0;
         for (auto&& c : v)
           sum += c;
@@ -34,7 +38,7 @@ namespace vectors {
       size_t size () const { return k; }
 
     private:
-      array_backed_sum_ (size_t k) : k {k} {}
+      array_backed_sum_ (size_t k) : k {(size_type) k} {}
       array_backed_sum_ (const self& other) = default;
 
     public:
@@ -160,12 +164,12 @@ namespace vectors {
       }
 
       auto bin () const {
-        return (sum + k) / k;
+        return ((int) sum + k) / k;
       }
 
     private:
-      const size_t k;
-      int sum = 0;
+      const size_type k;
+      sum_type sum = 0;
   };
 
 }
@@ -27,7 +27,10 @@ namespace vectors {
 
     public:
       simd_array_backed_ (std::span<const T> v) : k {v.size ()} {
-        data.back () ^= data.back ();
+        // Zero all the registers that are not fully overwritten, so that the
+        // padding lanes are neutral even if the capacity was rounded up.
+        for (size_t i = v.size () / simd_size; i < nsimds; ++i)
+          data[i] = 0;
         // Trust memcpy to DTRT.
         std::memcpy ((char*) data.data (), (char*) v.data (), v.size ());
       }
@@ -4,8 +4,10 @@
 #include <experimental/simd>
 #include <iostream>
 
+#include "configuration.hh"
 #include "vectors/simd_po_res.hh"
 #include "utils/simd_traits.hh"
+#include "utils/narrowest_int.hh"
 
 namespace vectors {
   template <typename T, size_t nsimds>
@@ -19,6 +21,7 @@ namespace vectors {
       using self = simd_array_backed_sum_<T, nsimds>;
       using traits = utils::simd_traits<T>;
       static const auto simd_size = traits::simd_size;
+      static constexpr bool unrolled = (nsimds <= SIMD_UNROLL_MAX);
 
     public:
       using value_type = T;
@@ -31,11 +34,22 @@ namespace vectors {
         sum = 0;
         for (auto&& c : v)
           sum += c;
-        data.back () ^= data.back ();
+        // Zero all the registers that are not fully overwritten, so that the
+        // padding lanes are neutral even if the capacity was rounded up.
+        for (size_t i = v.size () / simd_size; i < nsimds; ++i)
+          data[i] = 0;
         // Trust memcpy to DTRT.
         std::memcpy ((char*) data.data (), (char*) v.data (), v.size ());
       }
 
+      // See has_emplace.
+      template <typename F>
+      simd_array_backed_sum_ (emplace_t, size_t k, const F& fill) : k {k} {
+        for (size_t i = k / simd_size; i < nsimds; ++i)
+          data[i] = 0;
+        sum = fill ((T*) data.data ());
+      }
+
       simd_array_backed_sum_ () = delete;
       simd_array_backed_sum_ (const self& other) = delete;
       simd_array_backed_sum_ (self&& other) = default;
@@ -66,7 +80,10 @@ namespace vectors {
 
 
       inline auto partial_order (const self& rhs) const {
-        return simd_po_res (*this, rhs);
+        if constexpr (unrolled)
+          return simd_po_res_unrolled<self, nsimds> (*this, rhs);
+        else
+          return simd_po_res (*this, rhs);
       }
 
       // Used by Sets, should be a total order.  Do not use.
@@ -86,11 +103,20 @@ namespace vectors {
       bool operator== (const self& rhs) const {
         if (sum != rhs.sum)
           return false;
+        if constexpr (unrolled) {
+          auto eq = data[0] == rhs.data[0];
+          utils::unroll<nsimds - 1> ([&] (auto i) {
+            eq = eq && (data[i + 1] == rhs.data[i + 1]);
+          });
+          return std::experimental::all_of (eq);
+        }
         // Trust memcmp to DTRT
         return std::memcmp ((char*) rhs.data.data (), (char*) data.data (), nsimds * simd_size) == 0;
       }
 
       bool operator!= (const self& rhs) const {
+        if constexpr (unrolled)
+          return not (*this == rhs);
         if (sum != rhs.sum)
           return true;
         // Trust memcmp to DTRT
@@ -100,6 +126,20 @@ namespace vectors {
       self meet (const self& rhs) const {
         auto res = self (k);
 
+        // Widen to the narrowest type that cannot overflow, and reduce in
+        // registers, if there is a fixed-size simd that wide.
+        using sum_t = utils::narrowest_sum<T, nsimds * simd_size>;
+        if constexpr (unrolled and simd_size <= std::experimental::simd_abi::max_fixed_size<sum_t>) {
+          using wide = std::experimental::rebind_simd_t<sum_t, typename traits::fssimd>;
+          wide acc = 0;
+          utils::unroll<nsimds> ([&] (auto i) {
+            res.data[i] = std::experimental::min (data[i], rhs.data[i]);
+            acc += std::experimental::static_simd_cast<wide> (res.data[i]);
+          });
+          res.sum = std::experimental::reduce (acc);
+          return res;
+        }
+
         for (size_t i = 0; i < nsimds; ++i) {
           res.data[i] = std::experimental::min (data[i], rhs.data[i]);
           // This should NOT be used since this can lead to overflows over char
@@ -136,6 +176,7 @@ namespace vectors {
 
     private:
       friend simd_po_res<self>;
+      friend simd_po_res_unrolled<self, nsimds>;
       std::array<typename traits::fssimd, nsimds> data;
       const size_t k;
       int sum = 0;
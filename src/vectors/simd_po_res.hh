@@ -1,4 +1,7 @@
 #pragma once
+
+#include "utils/unroll.hh"
+
 namespace vectors {
   template <typename Vec>
   class simd_po_res {
@@ -81,4 +84,37 @@ namespace vectors {
         has_bleq = false;
       size_t up_to = 0;
   };
+
+  // For vectors that fit in a handful of registers, computing both directions
+  // at once without branches is cheaper than the lazy evaluation above.
+  template <typename Vec, size_t nsimds>
+  class simd_po_res_unrolled {
+    public:
+      simd_po_res_unrolled (const Vec& lhs, const Vec& rhs) {
+        bgeq = (lhs.sum >= rhs.sum);
+        bleq = (lhs.sum <= rhs.sum);
+        if (not bgeq and not bleq)
+          return;
+
+        auto ge = lhs.data[0] >= rhs.data[0];
+        auto le = lhs.data[0] <= rhs.data[0];
+        utils::unroll<nsimds - 1> ([&] (auto i) {
+          ge = ge && (lhs.data[i + 1] >= rhs.data[i + 1]);
+          le = le && (lhs.data[i + 1] <= rhs.data[i + 1]);
+        });
+        bgeq = bgeq and std::experimental::all_of (ge);
+        bleq = bleq and std::experimental::all_of (le);
+      }
+
+      inline bool geq () {
+        return bgeq;
+      }
+
+      inline bool leq () {
+        return bleq;
+      }
+
+    private:
+      bool bgeq, bleq;
+  };
 }
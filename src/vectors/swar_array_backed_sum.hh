@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <span>
+
+#include "vectors/swar_po_res.hh"
+#include "utils/swar.hh"
+#include "utils/narrowest_int.hh"
+
+namespace vectors {
+  template <typename T, size_t nwords>
+  class swar_array_backed_sum_;
+
+  template <typename T, size_t K>
+  using swar_array_backed_sum = swar_array_backed_sum_<T, utils::swar::nwords (K * sizeof (T))>;
+
+  template <typename T, size_t nwords>
+  class swar_array_backed_sum_ {
+      static_assert (sizeof (T) == 1, "SWAR vectors pack one byte per element.");
+      using self = swar_array_backed_sum_<T, nwords>;
+      using word = utils::swar::word;
+      // k and sum sit in the padding after data, so keep them narrow.
+      using size_type = utils::narrowest_uint<nwords * utils::swar::bytes_per_word>;
+      using sum_type = utils::narrowest_sum<T, nwords * utils::swar::bytes_per_word>;
+
+    public:
+      using value_type = T;
+
+    private:
+      swar_array_backed_sum_ (size_t k) : k {(size_type) k} { }
+
+    public:
+      swar_array_backed_sum_ (std::span<const T> v) : k {(size_type) v.size ()} {
+        assert (k <= capacity_for (k));
+        data.fill (0);
+        std::memcpy ((char*) data.data (), (char*) v.data (), v.size ());
+        sum = utils::swar::sum (data.data (), nwords);
+      }
+
+      // See has_emplace.
+      template <typename F>
+      swar_array_backed_sum_ (emplace_t, size_t k, const F& fill) : k {(size_type) k} {
+        assert (k <= capacity_for (k));
+        data.fill (0);
+        sum = fill ((T*) data.data ());
+      }
+
+      swar_array_backed_sum_ () = delete;
+      swar_array_backed_sum_ (const self& other) = delete;
+      swar_array_backed_sum_ (self&& other) = default;
+
+      // explicit copy operator
+      self copy () const {
+        auto res = self (k);
+        res.data = data;
+        res.sum = sum;
+        return res;
+      }
+
+      self& operator= (self&& other) {
+        assert (other.k == k);
+        data = std::move (other.data);
+        sum = other.sum;
+        return *this;
+      }
+
+      self& operator= (const self& other) = delete;
+
+      static constexpr size_t capacity_for (size_t) {
+        return nwords * utils::swar::bytes_per_word;
+      }
+
+      void to_vector (std::span<T> v) const {
+        assert (v.size () >= k);
+        std::memcpy ((char*) v.data (), (char*) data.data (), k);
+      }
+
+      inline auto partial_order (const self& rhs) const {
+        assert (rhs.k == k);
+        return swar_po_res (*this, rhs);
+      }
+
+      // Used by Sets, should be a total order.  Do not use.
+      bool operator< (const self& rhs) const {
+        return data < rhs.data;
+      }
+
+      bool operator== (const self& rhs) const {
+        return sum == rhs.sum and data == rhs.data;
+      }
+
+      bool operator!= (const self& rhs) const {
+        return sum != rhs.sum or data != rhs.data;
+      }
+
+      self meet (const self& rhs) const {
+        assert (rhs.k == k);
+        auto res = self (k);
+        res.sum = utils::swar::meet (data.data (), rhs.data.data (), res.data.data (), nwords);
+        return res;
+      }
+
+      auto size () const {
+        return k;
+      }
+
+      T operator[] (size_t i) const {
+        return ((const T*) data.data ())[i];
+      }
+
+      auto bin () const {
+        return ((int) sum + k) / k;
+      }
+
+    private:
+      friend swar_po_res<self>;
+      std::array<word, nwords> data;
+      const size_type k;
+      sum_type sum = 0;
+  };
+
+  template <typename T>
+  struct traits<swar_array_backed_sum, T> {
+      static constexpr auto capacity_for (size_t elts) {
+        return utils::swar::nwords (elts * sizeof (T)) * utils::swar::bytes_per_word / sizeof (T);
+      }
+  };
+}
+
+template <typename T, size_t nwords>
+inline
+std::ostream& operator<<(std::ostream& os, const vectors::swar_array_backed_sum_<T, nwords>& v)
+{
+  os << "{ ";
+  for (size_t i = 0; i < v.size (); ++i)
+    os << (int) v[i] << " ";
+  os << "}";
+  return os;
+}
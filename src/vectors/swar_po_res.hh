@@ -0,0 +1,31 @@
+#pragma once
+
+#include "utils/swar.hh"
+
+namespace vectors {
+  template <typename Vec>
+  class swar_po_res {
+    public:
+      swar_po_res (const Vec& lhs, const Vec& rhs) {
+        bgeq = (lhs.sum >= rhs.sum);
+        bleq = (lhs.sum <= rhs.sum);
+
+        const size_t nwords = lhs.data.size ();
+        for (size_t i = 0; i < nwords and (bgeq or bleq); ++i) {
+          bgeq = bgeq and utils::swar::all_geq (lhs.data[i], rhs.data[i]);
+          bleq = bleq and utils::swar::all_geq (rhs.data[i], lhs.data[i]);
+        }
+      }
+
+      inline bool geq () {
+        return bgeq;
+      }
+
+      inline bool leq () {
+        return bleq;
+      }
+
+    private:
+      bool bgeq, bleq;
+  };
+}
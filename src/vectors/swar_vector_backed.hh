@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <vector>
+
+#include "vectors/swar_po_res.hh"
+#include "utils/swar.hh"
+
+namespace vectors {
+  template <typename T>
+  class swar_vector_backed {
+      static_assert (sizeof (T) == 1, "SWAR vectors pack one byte per element.");
+      using self = swar_vector_backed<T>;
+      using word = utils::swar::word;
+
+    public:
+      using value_type = T;
+
+    private:
+      swar_vector_backed (size_t k) : k {k},
+                                      data (utils::swar::nwords (k)) {
+        assert (data.size () >= 1);
+      }
+
+    public:
+      swar_vector_backed (std::span<const T> v) : swar_vector_backed (v.size ()) {
+        // The vector constructor zeroed the padding.
+        std::memcpy ((char*) data.data (), (char*) v.data (), v.size ());
+        sum = utils::swar::sum (data.data (), data.size ());
+      }
+
+      swar_vector_backed () = delete;
+      swar_vector_backed (const self& other) = delete;
+      swar_vector_backed (self&& other) = default;
+
+      self copy () const {
+        auto res = self (k);
+        res.data = data;
+        res.sum = sum;
+        return res;
+      }
+
+      self& operator= (self&& other) {
+        assert (other.k == k);
+        data = std::move (other.data);
+        sum = other.sum;
+        return *this;
+      }
+
+      self& operator= (const self& other) = delete;
+
+      static constexpr size_t capacity_for (size_t elts) {
+        return utils::swar::nwords (elts) * utils::swar::bytes_per_word;
+      }
+
+      void to_vector (std::span<T> v) const {
+        assert (v.size () >= k);
+        std::memcpy ((char*) v.data (), (char*) data.data (), k);
+      }
+
+      inline auto partial_order (const self& rhs) const {
+        assert (rhs.k == k);
+        return swar_po_res (*this, rhs);
+      }
+
+      bool operator== (const self& rhs) const {
+        return sum == rhs.sum and data == rhs.data;
+      }
+
+      bool operator!= (const self& rhs) const {
+        return sum != rhs.sum or data != rhs.data;
+      }
+
+      // Used by Sets, should be a total order.  Do not use.
+      bool operator< (const self& rhs) const {
+        return data < rhs.data;
+      }
+
+      T operator[] (size_t i) const {
+        return ((const T*) data.data ())[i];
+      }
+
+      self meet (const self& rhs) const {
+        assert (rhs.k == k);
+        auto res = self (k);
+        res.sum = utils::swar::meet (data.data (), rhs.data.data (), res.data.data (), data.size ());
+        return res;
+      }
+
+      auto size () const {
+        return k;
+      }
+
+      auto bin () const {
+        return (sum + k) / k;
+      }
+
+    private:
+      friend swar_po_res<self>;
+      const size_t k;
+      std::vector<word> data;
+      int sum = 0;
+  };
+
+  template <typename T>
+  struct traits<swar_vector_backed, T> {
+      static constexpr auto capacity_for (size_t elts) {
+        return utils::swar::nwords (elts * sizeof (T)) * utils::swar::bytes_per_word / sizeof (T);
+      }
+  };
+}
+
+template <typename T>
+inline
+std::ostream& operator<<(std::ostream& os, const vectors::swar_vector_backed<T>& v)
+{
+  os << "{ ";
+  for (size_t i = 0; i < v.size (); ++i)
+    os << (int) v[i] << " ";
+  os << "}";
+  return os;
+}
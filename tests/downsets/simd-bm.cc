@@ -17,7 +17,9 @@
 
 #include "test_maker.hh"
 
-#define DIMENSION 64
+#ifndef DIMENSION
+# define DIMENSION 64
+#endif
 #define ROUNDS 3
 #define NITEMS (1 << 14)
 #define MAXVAL 3
@@ -61,25 +63,34 @@ struct test_t : public generic_test_t {
 };
 
 namespace vectors{
+#ifndef NO_SIMD
   template <typename T>
   using simd_array_backed_sum_fixed = vectors::simd_array_backed_sum<T, DIMENSION>;
 
   template <typename T>
   using simd_array_backed_fixed = vectors::simd_array_backed<T, DIMENSION>;
+#endif
 
   template <typename T>
   using array_backed_fixed = vectors::array_backed<T, DIMENSION>;
 
   template <typename T>
   using array_backed_sum_fixed = vectors::array_backed_sum<T, DIMENSION>;
+
+  template <typename T>
+  using swar_array_backed_sum_fixed = vectors::swar_array_backed_sum<T, DIMENSION>;
 }
 
 using vector_types = type_list<vectors::vector_backed<test_value_type>,
                                vectors::array_backed_fixed<test_value_type>,
                                vectors::array_backed_sum_fixed<test_value_type>,
+#ifndef NO_SIMD
                                vectors::simd_vector_backed<test_value_type>,
                                vectors::simd_array_backed_fixed<test_value_type>,
-                               vectors::simd_array_backed_sum_fixed<test_value_type>>;
+                               vectors::simd_array_backed_sum_fixed<test_value_type>,
+#endif
+                               vectors::swar_vector_backed<test_value_type>,
+                               vectors::swar_array_backed_sum_fixed<test_value_type>>;
 
 using set_types = template_type_list<downsets::vector_backed,
                                      downsets::vector_backed_bin>;
@@ -5,6 +5,7 @@
 #include <set>
 #include <vector>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <cxxabi.h>
 
@@ -21,6 +22,12 @@ struct has_insert<T, std::void_t<decltype(std::declval<T>().insert (std::declval
 
 #define il std::initializer_list<char>
 
+template <class T>
+struct is_dynamic_bitset : std::false_type {};
+
+template <class X>
+struct is_dynamic_bitset<vectors::X_and_bitset<X, vectors::dynamic_nbitsets>> : std::true_type {};
+
 template<typename SetType>
 struct test_t : public generic_test_t {
     using VType = typename SetType::value_type;
@@ -46,6 +53,12 @@ struct test_t : public generic_test_t {
     }
 
     void operator() () {
+      // The static bitset holds at least 64 Booleans; the dynamic one is
+      // given three words.  This runs first, so that it is not skipped when
+      // the numeric part fails one of the checks below.
+      if constexpr (vectors::has_bitset<VType>::value)
+        test_bools (is_dynamic_bitset<VType>::value ? 130 : 40);
+
       VType v1 (il {1, 2, 3});
       VType v2 (il {2, 5, 1});
       VType v3 (il {4, 1, 1});
@@ -114,6 +127,18 @@ struct test_t : public generic_test_t {
       assert (tree.contains (VType (il {2, 1, 1})));
       set = set.apply ([] (const VType& v) { return v.copy (); });
 
+      if constexpr (downsets::has_apply_by_block<SetType>::value) {
+        auto set_cpy = set.apply_by_block ([] (std::span<const VType> block) {
+          std::vector<VType> out;
+          for (const auto& v : block)
+            out.push_back (v.copy ());
+          return out;
+        });
+        assert (set_cpy.size () == set.size ());
+        for (const auto& v : set)
+          assert (set_cpy.contains (v));
+      }
+
       // std::cout << "We built the kdtree!" << std::endl;
 
       VType v4 (il {0, 1, 2});
@@ -130,6 +155,15 @@ struct test_t : public generic_test_t {
       assert(set.contains(v4));
       assert(!set.contains(v5));
 
+      if constexpr (downsets::has_contains_any<SetType>::value) {
+        std::vector<VType> queries;
+        queries.push_back (v5.copy ());
+        queries.push_back (v4.copy ());
+        assert (set.contains_any (queries) == 1);
+        queries.pop_back ();
+        assert (set.contains_any (queries) == 1);
+      }
+
 
       std::vector<VType> others;
       others.emplace_back(v4.copy ());
@@ -221,6 +255,60 @@ struct test_t : public generic_test_t {
       }
     }
 
+    // Vectors with 3 numeric states and nbools Boolean states, stored in the
+    // bitset part.
+    void test_bools (size_t nbools) {
+      auto saved = std::tuple (vectors::bool_threshold, vectors::bitset_threshold, vectors::nbitsetbools);
+      vectors::bool_threshold = vectors::bitset_threshold = 3;
+      vectors::nbitsetbools = nbools;
+
+      auto mk = [&] (std::vector<char> numeric, std::vector<size_t> trues) {
+        numeric.resize (3 + nbools, -1);
+        for (auto b : trues)
+          numeric[3 + b] = 0;
+        return numeric;
+      };
+      const size_t last = nbools - 1, mid = nbools / 2 + 1;
+
+      VType a (mk ({2, 2, 2}, {0, mid, last}));
+      VType b (mk ({1, 1, 1}, {0, mid}));
+      VType c (mk ({1, 1, 1}, {1}));
+      assert (a.size () == 3 + nbools);
+
+      // Reading the Booleans back.
+      assert (a[3 + mid] == 0 and a[3 + mid - 1] == -1 and a[3 + last] == 0);
+      std::vector<char> out (a.size ());
+      a.to_vector (std::span (out));
+      assert (out == mk ({2, 2, 2}, {0, mid, last}));
+
+      // Building from the words of the bitset gives the same vector.
+      std::vector<unsigned long> words (vectors::nbools_to_nbitsets (nbools));
+      for (auto i : {(size_t) 0, mid, last})
+        words[i / (sizeof (unsigned long) * 8)] |= 1ul << (i % (sizeof (unsigned long) * 8));
+      std::vector<char> numeric = {2, 2, 2};
+      assert (VType (std::span<const char> (numeric), std::span<const unsigned long> (words), nbools) == a);
+
+      // Domination looks at the Booleans.
+      assert (b.partial_order (a).leq () and not b.partial_order (a).geq ());
+      assert (not c.partial_order (a).leq () and not c.partial_order (a).geq ());
+      assert (a.meet (b) == b);
+      assert (a.meet (c) == VType (mk ({1, 1, 1}, {})));
+      assert ((a < b) != (b < a) and (b < c) != (c < b));
+      if constexpr (vectors::has_bin<VType>::value)
+        assert (a.bin () > b.bin ());
+
+      std::vector<VType> elements;
+      elements.push_back (a.copy ());
+      elements.push_back (c.copy ());
+      auto set = vec_to_set (std::move (elements));
+      assert (set.contains (b));
+      assert (set.contains (VType (mk ({0, 0, 0}, {1}))));
+      assert (not set.contains (VType (mk ({1, 1, 1}, {0, 1}))));
+      assert (not set.contains (VType (mk ({1, 1, 1}, {last - 1}))));
+
+      std::tie (vectors::bool_threshold, vectors::bitset_threshold, vectors::nbitsetbools) = saved;
+    }
+
 };
 
 
@@ -244,11 +332,13 @@ void usage (const char* progname) {
 }
 
 namespace vectors {
+#ifndef NO_SIMD
   template <typename T>
   using simd_array_backed_sum_fixed = vectors::simd_array_backed_sum<T, 10>;
 
   template <typename T>
   using simd_array_backed_fixed = vectors::simd_array_backed<T, 10>;
+#endif
 
   template <typename T>
   using array_backed_fixed = vectors::array_backed<T, 10>;
@@ -256,15 +346,30 @@ namespace vectors {
   template <typename T>
   using array_backed_sum_fixed = vectors::array_backed_sum<T, 10>;
 
+  template <typename T>
+  using swar_array_backed_sum_fixed = vectors::swar_array_backed_sum<T, 10>;
 }
 
+#ifndef NO_SIMD
 using vector_types = type_list<vectors::vector_backed<char>,
                                vectors::array_backed_fixed<char>,
                                vectors::array_backed_sum_fixed<char>,
                                vectors::simd_vector_backed<char>,
                                vectors::simd_array_backed_fixed<char>,
                                vectors::simd_array_backed_sum_fixed<char>,
-                               vectors::X_and_bitset<vectors::simd_vector_backed<char>, 1>>;
+                               vectors::swar_vector_backed<char>,
+                               vectors::swar_array_backed_sum_fixed<char>,
+                               vectors::X_and_bitset<vectors::simd_vector_backed<char>, 1>,
+                               vectors::X_and_bitset<vectors::swar_vector_backed<char>, vectors::dynamic_nbitsets>>;
+#else
+using vector_types = type_list<vectors::vector_backed<char>,
+                               vectors::array_backed_fixed<char>,
+                               vectors::array_backed_sum_fixed<char>,
+                               vectors::swar_vector_backed<char>,
+                               vectors::swar_array_backed_sum_fixed<char>,
+                               vectors::X_and_bitset<vectors::swar_vector_backed<char>, 1>,
+                               vectors::X_and_bitset<vectors::swar_vector_backed<char>, vectors::dynamic_nbitsets>>;
+#endif
 
 using set_types = template_type_list<//downsets::full_set, ; too slow.
                                      downsets::kdtree_backed,